@@ -0,0 +1,184 @@
+/**
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Times ptk::file_list::sort_files() for every sortable column on synthetic files.
+//
+// usage: benchmark-ptk-file-list-sort [FILES]
+
+#include <string>
+#include <string_view>
+
+#include <format>
+#include <print>
+
+#include <array>
+#include <vector>
+
+#include <algorithm>
+
+#include <random>
+
+#include <memory>
+
+#include <chrono>
+
+#include <cstdlib>
+
+#include <sys/stat.h>
+
+#include <gtk/gtk.h>
+
+#include <magic_enum.hpp>
+
+#include <ztd/ztd.hxx>
+
+#include "vfs/vfs-file.hxx"
+#include "vfs/vfs-mime-type.hxx"
+
+#include "ptk/ptk-file-list.hxx"
+
+[[nodiscard]] static std::vector<std::shared_ptr<vfs::file>>
+make_files(const usize count) noexcept
+{
+    std::mt19937_64 rng(0x5f3759df);
+
+    const std::vector<std::shared_ptr<vfs::mime_type>> mime_types{
+        vfs::mime_type::create_from_type("text/plain"),
+        vfs::mime_type::create_from_type("image/png"),
+        vfs::mime_type::create_from_type("image/jpeg"),
+        vfs::mime_type::create_from_type("video/mp4"),
+        vfs::mime_type::create_from_type("application/pdf"),
+        vfs::mime_type::create_from_type("application/x-executable"),
+        vfs::mime_type::create_from_type("inode/directory"),
+    };
+    const std::vector<std::string_view> prefixes{
+        "IMG_", "report ", "Track ", "file", "build-", ".config"};
+    const std::vector<std::string_view> suffixes{".txt", ".png", ".jpg", ".mp4", ".pdf", "", ""};
+
+    const auto timestamp = [&rng]() -> struct ::statx_timestamp
+    {
+        return {static_cast<i64>(rng() % 2'000'000'000),
+                static_cast<u32>(rng() % 1'000'000'000),
+                0};
+    };
+
+    std::vector<std::shared_ptr<vfs::file>> files;
+    files.reserve(count);
+    for (usize i = 0; i < count; ++i)
+    {
+        const auto kind = rng() % mime_types.size();
+        const bool is_dir = kind + 1 == mime_types.size();
+
+        vfs::file::stat_data stat;
+        stat.size = is_dir ? 4096 : rng() % (u64(1) << (rng() % 40));
+        stat.blocks = stat.size / 512;
+        stat.ino = i + 1;
+        stat.atime = timestamp();
+        stat.btime = timestamp();
+        stat.ctime = timestamp();
+        stat.mtime = timestamp();
+        stat.uid = 1000 + static_cast<u32>(rng() % 4);
+        stat.gid = 1000 + static_cast<u32>(rng() % 4);
+        stat.mode = static_cast<u16>((is_dir ? S_IFDIR : S_IFREG) | ((rng() % 2) ? 0755 : 0644));
+
+        // digit runs of varying length exercise natural sorting
+        const auto name = std::format("{}{}{}",
+                                      prefixes[rng() % prefixes.size()],
+                                      rng() % (u64(10) << (rng() % 6)),
+                                      is_dir ? "" : suffixes[kind]);
+
+        files.push_back(vfs::file::create(std::format("/synthetic/{}-{}", name, i),
+                                          stat,
+                                          mime_types[kind]));
+    }
+    return files;
+}
+
+[[nodiscard]] static std::chrono::microseconds
+time_sort(std::vector<std::shared_ptr<vfs::file>>& files,
+          ptk::file_list::sort_key_cache& keys) noexcept
+{
+    const auto start = std::chrono::steady_clock::now();
+    ptk::file_list::sort_files(files, keys);
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                                 start);
+}
+
+int
+main(int argc, char** argv) noexcept
+{
+    gtk_init(&argc, &argv);
+
+    const usize count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+
+    const auto generate_start = std::chrono::steady_clock::now();
+    const auto files = make_files(count);
+    const auto generate_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - generate_start);
+
+    std::println("files:      {}", files.size());
+    std::println("generated:  {}", generate_time);
+    std::println("");
+    std::println("{:<8} {:<8} {:>14} {:>14}", "column", "natural", "cold keys", "cached keys");
+
+    constexpr std::array columns{
+        ptk::file_list::column::name,
+        ptk::file_list::column::size,
+        ptk::file_list::column::bytes,
+        ptk::file_list::column::type,
+        ptk::file_list::column::mime,
+        ptk::file_list::column::perm,
+        ptk::file_list::column::owner,
+        ptk::file_list::column::group,
+        ptk::file_list::column::atime,
+        ptk::file_list::column::btime,
+        ptk::file_list::column::ctime,
+        ptk::file_list::column::mtime,
+    };
+
+    for (const auto column : columns)
+    {
+        for (const bool natural : {false, true})
+        {
+            if (natural && column != ptk::file_list::column::name)
+            {
+                continue;
+            }
+
+            ptk::file_list::sort_key_cache keys;
+            keys.set_options({column,
+                              GtkSortType::GTK_SORT_ASCENDING,
+                              ptk::file_list::sort_dir::first,
+                              natural,
+                              false,
+                              true});
+
+            auto sorted = files;
+            const auto cold = time_sort(sorted, keys);
+
+            // same files in the original order, every key is cached now
+            sorted = files;
+            const auto cached = time_sort(sorted, keys);
+
+            std::println("{:<8} {:<8} {:>14} {:>14}",
+                         magic_enum::enum_name(column),
+                         natural,
+                         cold,
+                         cached);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
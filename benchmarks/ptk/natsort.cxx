@@ -0,0 +1,128 @@
+/**
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Compares the throughput of strnatcmp() and ptk::natsort on synthetic file names.
+//
+// usage: benchmark-ptk-natsort [NAMES]
+
+#include <string>
+#include <string_view>
+
+#include <format>
+#include <print>
+
+#include <vector>
+
+#include <algorithm>
+
+#include <functional>
+
+#include <random>
+
+#include <chrono>
+
+#include <cstdlib>
+
+#include <ztd/ztd.hxx>
+
+#include "ptk/natsort/natural.hxx"
+#include "ptk/natsort/strnatcmp.hxx"
+
+[[nodiscard]] static std::vector<std::string>
+make_names(const usize count, const bool ascii) noexcept
+{
+    std::mt19937_64 rng(0x5f3759df);
+
+    const std::vector<std::string_view> ascii_words{
+        "IMG_", "Report ", "track ", "File", "build-", ".config", "Screenshot from 2024-"};
+    const std::vector<std::string_view> utf8_words{
+        "Ärger ", "straße", "Écoles ", "файл ", "Σίσυφος ", "日本語 "};
+    const std::vector<std::string_view> suffixes{".txt", ".png", ".jpg", ".tar.gz", ""};
+
+    std::vector<std::string> names;
+    names.reserve(count);
+    for (usize i = 0; i < count; ++i)
+    {
+        const auto& words = (ascii || rng() % 2) ? ascii_words : utf8_words;
+        names.push_back(std::format("{}{}{}",
+                                    words[rng() % words.size()],
+                                    rng() % (u64(10) << (rng() % 8)),
+                                    suffixes[rng() % suffixes.size()]));
+    }
+    return names;
+}
+
+static void
+run(const std::string_view label, const std::vector<std::string>& names,
+    const std::function<i32(const std::string&, const std::string&)>& compare,
+    const std::function<std::string(const std::string&)>& prepare = nullptr) noexcept
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::string> sorted;
+    sorted.reserve(names.size());
+    for (const auto& name : names)
+    {
+        sorted.push_back(prepare ? prepare(name) : name);
+    }
+
+    u64 comparisons = 0;
+    std::ranges::sort(sorted,
+                      [&](const std::string& a, const std::string& b)
+                      {
+                          ++comparisons;
+                          return compare(a, b) < 0;
+                      });
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    std::println("{:<28} {:>12} {:>10.1f} Mcmp/s",
+                 label,
+                 elapsed,
+                 double(comparisons) / double(elapsed.count()));
+}
+
+int
+main(int argc, char** argv) noexcept
+{
+    const usize count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+
+    for (const bool ascii : {true, false})
+    {
+        const auto names = make_names(count, ascii);
+
+        std::println("{} names, {}", names.size(), ascii ? "ASCII" : "half UTF-8");
+
+        run("strnatcmp", names, [](const auto& a, const auto& b) { return strnatcmp(a, b); });
+        run("natsort::compare",
+            names,
+            [](const auto& a, const auto& b) { return ptk::natsort::compare(a, b); });
+        run("strnatcasecmp",
+            names,
+            [](const auto& a, const auto& b) { return strnatcasecmp(a, b); });
+        run("natsort::compare_icase",
+            names,
+            [](const auto& a, const auto& b) { return ptk::natsort::compare_icase(a, b); });
+        run("natsort::fold + compare",
+            names,
+            [](const auto& a, const auto& b) { return ptk::natsort::compare(a, b); },
+            [](const auto& name) { return ptk::natsort::fold(name); });
+
+        std::println("");
+    }
+
+    return EXIT_SUCCESS;
+}
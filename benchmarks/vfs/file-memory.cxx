@@ -0,0 +1,191 @@
+/**
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// Reports the heap memory used per vfs::file when reading a directory,
+// next to the memory the same files used with the old vfs::file layout.
+//
+// usage: benchmark-vfs-file-memory [DIRECTORY]
+
+#include <string>
+
+#include <filesystem>
+
+#include <print>
+
+#include <vector>
+
+#include <utility>
+
+#include <algorithm>
+
+#include <memory>
+
+#include <chrono>
+
+#include <cstdlib>
+
+#include <malloc.h>
+
+#include <gtk/gtk.h>
+
+#include <ztd/ztd.hxx>
+
+#include "vfs/vfs-file.hxx"
+
+#include "vfs/linux/dirent.hxx"
+
+// the members of vfs::file before its layout was shrunk. the old
+// constructor filled the uri and every display string right away.
+struct old_file : public std::enable_shared_from_this<old_file>
+{
+    struct ::statx file_stat{}; // ztd::statx, a copy of the full struct statx
+    std::filesystem::file_status status;
+
+    std::filesystem::path path;
+    std::string uri;
+
+    std::string name;
+    std::string display_size;
+    std::string display_size_bytes;
+    std::string display_disk_size;
+    std::string display_owner;
+    std::string display_group;
+    std::string display_atime;
+    std::string display_btime;
+    std::string display_ctime;
+    std::string display_mtime;
+    std::string display_perm;
+    std::shared_ptr<vfs::mime_type> mime_type;
+    GdkPixbuf* big_thumbnail{nullptr};
+    GdkPixbuf* small_thumbnail{nullptr};
+
+    bool is_special_desktop_entry{false};
+
+    bool is_hidden{false};
+};
+
+[[nodiscard]] static u64
+heap_in_use() noexcept
+{
+    const auto info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+}
+
+int
+main(int argc, char** argv) noexcept
+{
+    gtk_init(&argc, &argv);
+
+    const std::filesystem::path path = argc > 1 ? argv[1] : "/usr/share/doc";
+    if (!std::filesystem::is_directory(path))
+    {
+        std::println("Not a directory: {}", path.string());
+        return EXIT_FAILURE;
+    }
+
+    vfs::linux::dirent::scanner scanner(path);
+    auto entries = scanner.read_all();
+
+    // warm the mime type and name caches so they are not counted per file
+    std::vector<std::pair<std::string, struct ::statx>> stated;
+    stated.reserve(entries.size());
+    for (auto& entry : entries)
+    {
+        struct ::statx stat{};
+        if (scanner.stat(entry, stat))
+        {
+            const auto file = vfs::file::create(path / entry.name, stat);
+            (void)file->display_owner();
+            (void)file->display_group();
+            stated.emplace_back(entry.name, stat);
+        }
+    }
+
+    malloc_trim(0);
+    const auto heap_before = heap_in_use();
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::shared_ptr<vfs::file>> files;
+    files.reserve(stated.size());
+    for (const auto& [name, stat] : stated)
+    {
+        files.push_back(vfs::file::create(path / name, stat));
+    }
+
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    const auto heap_after = heap_in_use();
+
+    // display strings are created lazily, touch them to report the worst case
+    for (const auto& file : files)
+    {
+        (void)file->display_size();
+        (void)file->display_size_in_bytes();
+        (void)file->display_size_on_disk();
+        (void)file->display_owner();
+        (void)file->display_group();
+        (void)file->display_atime();
+        (void)file->display_btime();
+        (void)file->display_ctime();
+        (void)file->display_mtime();
+        (void)file->display_permissions();
+    }
+    const auto heap_displayed = heap_in_use();
+
+    // the same files with the old layout, holding the same strings
+    malloc_trim(0);
+    const auto heap_before_old = heap_in_use();
+
+    std::vector<std::shared_ptr<old_file>> old_files;
+    old_files.reserve(files.size());
+    for (usize index = 0; index < files.size(); ++index)
+    {
+        const auto& file = files[index];
+
+        auto old = std::make_shared<old_file>();
+        old->file_stat = stated[index].second;
+        old->path = file->path();
+        old->uri = file->uri();
+        old->name = file->name();
+        old->display_size = file->display_size();
+        old->display_size_bytes = file->display_size_in_bytes();
+        old->display_disk_size = file->display_size_on_disk();
+        old->display_owner = file->display_owner();
+        old->display_group = file->display_group();
+        old->display_atime = file->display_atime();
+        old->display_btime = file->display_btime();
+        old->display_ctime = file->display_ctime();
+        old->display_mtime = file->display_mtime();
+        old->display_perm = file->display_permissions();
+        old->mime_type = file->mime_type();
+        old->is_hidden = file->is_hidden();
+        old_files.push_back(std::move(old));
+    }
+    const auto heap_after_old = heap_in_use();
+
+    const auto count = std::max(files.size(), usize(1));
+    std::println("directory:                 {}", path.string());
+    std::println("files:                     {}", files.size());
+    std::println("sizeof(vfs::file):         {} bytes, old layout {} bytes",
+                 sizeof(vfs::file),
+                 sizeof(old_file));
+    std::println("heap per file:             {} bytes", (heap_after - heap_before) / count);
+    std::println("heap per file, shown:      {} bytes", (heap_displayed - heap_before) / count);
+    std::println("heap per file, old layout: {} bytes",
+                 (heap_after_old - heap_before_old) / count);
+    std::println("create time:               {}",
+                 std::chrono::duration_cast<std::chrono::milliseconds>(elapsed));
+
+    return EXIT_SUCCESS;
+}
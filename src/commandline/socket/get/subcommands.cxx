@@ -570,6 +570,19 @@ commandline::socket::get::sort_first(CLI::App* app, const socket_subcommand_data
     sub->callback(run_subcommand);
 }
 
+/*
+ * subcommand sort-then
+ */
+
+void
+commandline::socket::get::sort_then(CLI::App* app, const socket_subcommand_data_t& opt) noexcept
+{
+    auto* sub = app->add_subcommand("sort-then", "Get property sort-then");
+
+    const auto run_subcommand = [opt]() { opt->property = "sort-then"; };
+    sub->callback(run_subcommand);
+}
+
 /*
  * subcommand show-thumbnails
  */
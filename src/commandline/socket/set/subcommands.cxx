@@ -1097,6 +1097,23 @@ commandline::socket::set::sort_first(CLI::App* app, const socket_subcommand_data
     setup_subcommand_set_sort_first_mixed(sub, opt);
 }
 
+/*
+ * subcommand sort-then
+ */
+
+void
+commandline::socket::set::sort_then(CLI::App* app, const socket_subcommand_data_t& opt) noexcept
+{
+    auto* sub = app->add_subcommand("sort-then", "Set property sort-then");
+
+    sub->add_option("value", opt->socket_data, "Secondary sort columns, eg 'mtime:desc,name'")
+        ->required(true)
+        ->expected(1);
+
+    const auto run_subcommand = [opt]() { opt->property = "sort-then"; };
+    sub->callback(run_subcommand);
+}
+
 /*
  * subcommand show-thumbnails
  */
@@ -52,6 +52,7 @@ void sort_natural(CLI::App* app, const socket_subcommand_data_t& opt) noexcept;
 void sort_case(CLI::App* app, const socket_subcommand_data_t& opt) noexcept;
 void sort_hidden_first(CLI::App* app, const socket_subcommand_data_t& opt) noexcept;
 void sort_first(CLI::App* app, const socket_subcommand_data_t& opt) noexcept;
+void sort_then(CLI::App* app, const socket_subcommand_data_t& opt) noexcept;
 void show_thumbnails(CLI::App* app, const socket_subcommand_data_t& opt) noexcept;
 void max_thumbnail_size(CLI::App* app, const socket_subcommand_data_t& opt) noexcept;
 void large_icons(CLI::App* app, const socket_subcommand_data_t& opt) noexcept;
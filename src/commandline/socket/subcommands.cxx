@@ -70,6 +70,7 @@ setup_subcommand_set(CLI::App* app, const socket_subcommand_data_t& opt) noexcep
     commandline::socket::set::sort_case(sub, opt);
     commandline::socket::set::sort_hidden_first(sub, opt);
     commandline::socket::set::sort_first(sub, opt);
+    commandline::socket::set::sort_then(sub, opt);
     commandline::socket::set::show_thumbnails(sub, opt);
     commandline::socket::set::max_thumbnail_size(sub, opt);
     commandline::socket::set::large_icons(sub, opt);
@@ -138,6 +139,7 @@ setup_subcommand_get(CLI::App* app, const socket_subcommand_data_t& opt) noexcep
     commandline::socket::get::sort_case(sub, opt);
     commandline::socket::get::sort_hidden_first(sub, opt);
     commandline::socket::get::sort_first(sub, opt);
+    commandline::socket::get::sort_then(sub, opt);
     commandline::socket::get::show_thumbnails(sub, opt);
     commandline::socket::get::max_thumbnail_size(sub, opt);
     commandline::socket::get::large_icons(sub, opt);
@@ -39,7 +39,7 @@ vector_to_glist_vfs_file(const std::span<const std::shared_ptr<vfs::file>> list)
     GList* l = nullptr;
     for (const auto& file : list)
     {
-        l = g_list_append(l, file.get());
+        l = g_list_prepend(l, file.get());
     }
-    return l;
+    return g_list_reverse(l);
 }
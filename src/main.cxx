@@ -39,6 +39,7 @@
 #include "main-window.hxx"
 
 #include "vfs/vfs-app-desktop.hxx"
+#include "vfs/vfs-dir-cache.hxx"
 #include "vfs/vfs-file.hxx"
 #include "vfs/vfs-user-dirs.hxx"
 
@@ -46,6 +47,7 @@
 
 #include "ptk/ptk-app-chooser.hxx"
 #include "ptk/ptk-dialog.hxx"
+#include "ptk/ptk-file-list-cache.hxx"
 #include "ptk/ptk-location-view.hxx"
 
 #include "utils/strdup.hxx"
@@ -305,6 +307,8 @@ main(int argc, char* argv[]) noexcept
     std::atexit(autosave::close);
     std::atexit(vfs::volume_finalize);
     std::atexit(save_bookmarks);
+    std::atexit(vfs::dir_cache::clear);
+    std::atexit(ptk::file_list_cache::clear);
 
     GtkApplication* app =
         gtk_application_new(PACKAGE_APPLICATION_NAME, G_APPLICATION_DEFAULT_FLAGS);
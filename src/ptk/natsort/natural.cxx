@@ -0,0 +1,317 @@
+/**
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+#include <string_view>
+
+#include <array>
+
+#include <algorithm>
+
+#include <bit>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <glib.h>
+
+#include <ztd/ztd.hxx>
+
+#include "ptk/natsort/natural.hxx"
+
+namespace
+{
+// character classes, same as std::isdigit()/std::isspace() in the "C" locale,
+// without a locale lookup per character
+enum char_class : u8
+{
+    none = 0,
+    digit = 1 << 0,
+    space = 1 << 1,
+};
+
+constexpr auto char_classes = []()
+{
+    std::array<u8, 256> table{};
+    for (char c = '0'; c <= '9'; ++c)
+    {
+        table[static_cast<u8>(c)] = char_class::digit;
+    }
+    for (const char c : {' ', '\t', '\n', '\v', '\f', '\r'})
+    {
+        table[static_cast<u8>(c)] = char_class::space;
+    }
+    return table;
+}();
+
+constexpr auto upper_case = []()
+{
+    std::array<u8, 256> table{};
+    for (usize i = 0; i < table.size(); ++i)
+    {
+        table[i] = (i >= 'a' && i <= 'z') ? static_cast<u8>(i - ('a' - 'A')) : static_cast<u8>(i);
+    }
+    return table;
+}();
+} // namespace
+
+[[nodiscard]] static bool
+is_digit(const char c) noexcept
+{
+    return char_classes[static_cast<u8>(c)] & char_class::digit;
+}
+
+[[nodiscard]] static bool
+is_space(const char c) noexcept
+{
+    return char_classes[static_cast<u8>(c)] & char_class::space;
+}
+
+[[nodiscard]] static u8
+to_upper(const char c) noexcept
+{
+    return upper_case[static_cast<u8>(c)];
+}
+
+// number of leading bytes that are ASCII
+[[nodiscard]] static usize
+ascii_prefix(const std::string_view str) noexcept
+{
+    usize i = 0;
+#if defined(__SSE2__)
+    for (; i + 16 <= str.size(); i += 16)
+    {
+        const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str.data() + i));
+        const auto high_bits = static_cast<u32>(_mm_movemask_epi8(chunk));
+        if (high_bits != 0)
+        {
+            return i + static_cast<usize>(std::countr_zero(high_bits));
+        }
+    }
+#endif
+    while (i < str.size() && static_cast<u8>(str[i]) < 0x80)
+    {
+        ++i;
+    }
+    return i;
+}
+
+// number of leading bytes that are the same in a and b, ASCII letters are
+// compared upper cased if fold_case is set.
+[[nodiscard]] static usize
+common_prefix(const char* a, const char* b, const usize size, const bool fold_case) noexcept
+{
+    usize i = 0;
+#if defined(__SSE2__)
+    // signed compares, bytes >= 0x80 are never in 'a'..'z'
+    const auto before_a = _mm_set1_epi8('a' - 1);
+    const auto after_z = _mm_set1_epi8('z' + 1);
+    const auto case_bit = _mm_set1_epi8('a' - 'A');
+    const auto upper = [&](const __m128i chunk)
+    {
+        const auto is_lower =
+            _mm_and_si128(_mm_cmpgt_epi8(chunk, before_a), _mm_cmplt_epi8(chunk, after_z));
+        return _mm_sub_epi8(chunk, _mm_and_si128(is_lower, case_bit));
+    };
+
+    for (; i + 16 <= size; i += 16)
+    {
+        auto chunk_a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        auto chunk_b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        if (fold_case)
+        {
+            chunk_a = upper(chunk_a);
+            chunk_b = upper(chunk_b);
+        }
+        const auto equal = static_cast<u32>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk_a, chunk_b)));
+        if (equal != 0xffff)
+        {
+            return i + static_cast<usize>(std::countr_one(equal));
+        }
+    }
+#endif
+    if (fold_case)
+    {
+        while (i < size && to_upper(a[i]) == to_upper(b[i]))
+        {
+            ++i;
+        }
+    }
+    else
+    {
+        while (i < size && a[i] == b[i])
+        {
+            ++i;
+        }
+    }
+    return i;
+}
+
+[[nodiscard]] static usize
+skip_spaces(const std::string_view str, usize i) noexcept
+{
+    while (i < str.size() && is_space(str[i]))
+    {
+        ++i;
+    }
+    return i;
+}
+
+[[nodiscard]] static usize
+digits_end(const std::string_view str, usize i) noexcept
+{
+    while (i < str.size() && is_digit(str[i]))
+    {
+        ++i;
+    }
+    return i;
+}
+
+[[nodiscard]] static i32
+compare_digits(const std::string_view a, const std::string_view b) noexcept
+{
+    // a run with a leading zero compares digit by digit, like a fraction.
+    // otherwise the longest run of digits wins, then the first different digit.
+    const bool fractional = a.front() == '0' || b.front() == '0';
+    if (!fractional && a.size() != b.size())
+    {
+        return a.size() < b.size() ? -1 : 1;
+    }
+    const auto result = a.compare(b);
+    return result < 0 ? -1 : (result > 0 ? 1 : 0);
+}
+
+[[nodiscard]] static i32
+natural_compare(const std::string_view a, const std::string_view b, const bool fold_case) noexcept
+{
+    usize ai = 0;
+    usize bi = 0;
+
+    while (true)
+    {
+        // skip the bytes both names share
+        const auto remaining = std::min(a.size() - ai, b.size() - bi);
+        usize same = common_prefix(a.data() + ai, b.data() + bi, remaining, fold_case);
+        ai += same;
+        bi += same;
+        // if the names differ inside a run of digits the whole run is compared
+        while (same > 0 && is_digit(a[ai - 1]))
+        {
+            --ai;
+            --bi;
+            --same;
+        }
+
+        ai = skip_spaces(a, ai);
+        bi = skip_spaces(b, bi);
+
+        if (ai == a.size() || bi == b.size())
+        {
+            // the shorter name is first
+            return static_cast<i32>(bi == b.size()) - static_cast<i32>(ai == a.size());
+        }
+
+        if (is_digit(a[ai]) && is_digit(b[bi]))
+        {
+            const auto a_end = digits_end(a, ai);
+            const auto b_end = digits_end(b, bi);
+            const auto result = compare_digits(a.substr(ai, a_end - ai), b.substr(bi, b_end - bi));
+            if (result != 0)
+            {
+                return result;
+            }
+            ai = a_end;
+            bi = b_end;
+            continue;
+        }
+
+        const u8 ca = fold_case ? to_upper(a[ai]) : static_cast<u8>(a[ai]);
+        const u8 cb = fold_case ? to_upper(b[bi]) : static_cast<u8>(b[bi]);
+        if (ca != cb)
+        {
+            return ca < cb ? -1 : 1;
+        }
+        ++ai;
+        ++bi;
+    }
+}
+
+i32
+ptk::natsort::compare(const std::string_view a, const std::string_view b) noexcept
+{
+    return natural_compare(a, b, false);
+}
+
+i32
+ptk::natsort::compare_icase(const std::string_view a, const std::string_view b) noexcept
+{
+    if (ascii_prefix(a) == a.size() && ascii_prefix(b) == b.size())
+    { // ASCII only, letters are folded while comparing
+        return natural_compare(a, b, true);
+    }
+    return natural_compare(ptk::natsort::fold(a), ptk::natsort::fold(b), false);
+}
+
+std::string
+ptk::natsort::fold(const std::string_view name) noexcept
+{
+    std::string key;
+    key.reserve(name.size());
+
+    // case folding can turn non ASCII characters into ASCII ones, KELVIN SIGN is 'k'
+    const auto append_upper = [&key](const std::string_view str)
+    {
+        for (const char c : str)
+        {
+            key.push_back(static_cast<char>(to_upper(c)));
+        }
+    };
+
+    usize i = 0;
+    while (i < name.size())
+    {
+        const auto ascii = ascii_prefix(name.substr(i));
+        append_upper(name.substr(i, ascii));
+        i += ascii;
+
+        // a run of non ASCII bytes, always whole UTF-8 characters if it is valid
+        usize end = i;
+        while (end < name.size() && static_cast<u8>(name[end]) >= 0x80)
+        {
+            ++end;
+        }
+        while (i < end)
+        {
+            const char* valid_end = nullptr;
+            g_utf8_validate(name.data() + i, static_cast<isize>(end - i), &valid_end);
+            const auto valid = static_cast<usize>(valid_end - (name.data() + i));
+            if (valid > 0)
+            {
+                char* folded = g_utf8_casefold(name.data() + i, static_cast<isize>(valid));
+                append_upper(folded);
+                g_free(folded);
+                i += valid;
+            }
+            if (i < end)
+            { // not valid UTF-8, keep the byte
+                key.push_back(name[i]);
+                ++i;
+            }
+        }
+    }
+
+    return key;
+}
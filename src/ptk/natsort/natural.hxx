@@ -0,0 +1,44 @@
+/**
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include <ztd/ztd.hxx>
+
+/**
+ * Natural order comparison for UTF-8 file names.
+ *
+ * Runs of ASCII digits are compared as numbers, a run starting with '0' is
+ * compared as a fraction, and whitespace is ignored. For ASCII input the
+ * results are the same as strnatcmp() and strnatcasecmp().
+ *
+ * Case insensitive comparison uses Unicode case folding. When the same names
+ * are compared many times, fold each name once with natsort::fold() and
+ * compare the folded names with natsort::compare().
+ */
+namespace ptk::natsort
+{
+// case sensitive, non ASCII characters compare in code point order
+[[nodiscard]] i32 compare(const std::string_view a, const std::string_view b) noexcept;
+// case insensitive, same as compare(fold(a), fold(b))
+[[nodiscard]] i32 compare_icase(const std::string_view a, const std::string_view b) noexcept;
+
+// case folded sort key, ASCII letters are upper cased, other valid UTF-8 is case folded.
+// bytes that are not valid UTF-8 are kept as is.
+[[nodiscard]] std::string fold(const std::string_view name) noexcept;
+} // namespace ptk::natsort
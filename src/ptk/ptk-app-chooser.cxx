@@ -37,7 +37,7 @@
 #include "vfs/vfs-mime-type.hxx"
 #include "vfs/vfs-user-dirs.hxx"
 
-#include "ptk/natsort/strnatcmp.hxx"
+#include "ptk/natsort/natural.hxx"
 #include "ptk/deprecated/async-task.hxx"
 
 #include "ptk/ptk-app-chooser.hxx"
@@ -98,7 +98,7 @@ sort_by_name(GtkTreeModel* model, GtkTreeIter* a, GtkTreeIter* b, void* user_dat
         gtk_tree_model_get(model, b, app_chooser_column::app_name, &name_b, -1);
         if (name_b)
         {
-            ret = strnatcasecmp(name_a, name_b);
+            ret = ptk::natsort::compare_icase(name_a, name_b);
         }
     }
     return ret;
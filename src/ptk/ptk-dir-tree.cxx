@@ -40,7 +40,7 @@
 #include "vfs/vfs-file.hxx"
 #include "vfs/utils/vfs-utils.hxx"
 
-#include "ptk/natsort/strnatcmp.hxx"
+#include "ptk/natsort/natural.hxx"
 #include "ptk/utils/ptk-utils.hxx"
 
 #include "ptk/ptk-dir-tree.hxx"
@@ -512,7 +512,7 @@ ptk::dir_tree::node_compare(const std::shared_ptr<ptk::dir_tree::node>& a,
     {
         return 0;
     }
-    return strnatcasecmp(file2->name(), file1->name());
+    return ptk::natsort::compare_icase(file2->name(), file1->name());
 }
 
 void
@@ -633,7 +633,8 @@ ptk::dir_tree::expand_row(GtkTreeIter* iter, GtkTreePath* tree_path) noexcept
                                      std::bind(&ptk::dir_tree::node::on_monitor_event,
                                                node,
                                                std::placeholders::_1,
-                                               std::placeholders::_2)};
+                                               std::placeholders::_2,
+                                               std::placeholders::_3)};
 
         for (const auto& file : std::filesystem::directory_iterator(path))
         {
@@ -783,8 +784,21 @@ ptk::dir_tree::node::find_node(const std::string_view name) const noexcept
 
 void
 ptk::dir_tree::node::on_monitor_event(const vfs::monitor::event event,
-                                      const std::filesystem::path& path) noexcept
+                                      const std::filesystem::path& path,
+                                      const std::filesystem::path& old_path) noexcept
 {
+    if (path == this->file->path())
+    { // the directory itself, its parent node handles it
+        return;
+    }
+
+    if (event == vfs::monitor::event::renamed)
+    { // child nodes are sorted by name, move the node by removing and adding it again
+        this->on_monitor_event(vfs::monitor::event::deleted, old_path, {});
+        this->on_monitor_event(vfs::monitor::event::created, path, {});
+        return;
+    }
+
     auto child = this->find_node(path.filename().string());
 
     if (event == vfs::monitor::event::created)
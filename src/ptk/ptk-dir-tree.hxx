@@ -79,8 +79,8 @@ struct dir_tree // : public std::enable_shared_from_this<ptk::dir_tree>, Gtk::Tr
         isize get_node_index(const std::shared_ptr<node>& child) const noexcept;
 
         /* file monitor callback */
-        void on_monitor_event(const vfs::monitor::event event,
-                              const std::filesystem::path& path) noexcept;
+        void on_monitor_event(const vfs::monitor::event event, const std::filesystem::path& path,
+                              const std::filesystem::path& old_path) noexcept;
     };
     std::shared_ptr<node> root{nullptr};
 
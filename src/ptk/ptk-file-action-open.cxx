@@ -222,7 +222,7 @@ ptk::action::open_files_with_app(const std::filesystem::path& cwd,
             {
                 const auto target_path = std::filesystem::read_symlink(file->path());
 
-                if (!std::filesystem::exists(target_path))
+                if (file->is_symlink_broken())
                 {
 #if (GTK_MAJOR_VERSION == 4)
                     GtkWidget* toplevel = GTK_WIDGET(gtk_widget_get_root(GTK_WIDGET(file_browser)));
@@ -77,6 +77,7 @@
 #include "ptk/ptk-file-task-view.hxx"
 
 #include "ptk/ptk-file-list.hxx"
+#include "ptk/ptk-file-list-cache.hxx"
 #include "ptk/ptk-clipboard.hxx"
 #include "ptk/ptk-file-menu.hxx"
 #include "ptk/ptk-path-bar.hxx"
@@ -1139,6 +1140,15 @@ ptk::browser::on_folder_content_changed(const std::shared_ptr<vfs::file>& file)
     }
 }
 
+void
+ptk::browser::on_folder_content_batch(const vfs::dir::change_set& changes) noexcept
+{
+    (void)changes;
+
+    // one status bar update for every file changed since the last notification
+    this->run_event<spacefm::signal::change_content>();
+}
+
 static void
 on_sort_col_changed(GtkTreeSortable* sortable, ptk::browser* file_browser) noexcept
 {
@@ -1188,32 +1198,88 @@ on_sort_col_changed(GtkTreeSortable* sortable, ptk::browser* file_browser) noexc
 }
 
 void
-ptk::browser::update_model(const std::string_view pattern) noexcept
+ptk::browser::update_model() noexcept
 {
+    // a list of the same directory being rebuilt keeps the search bar filter,
+    // going to another directory clears it
+    std::string pattern;
+    bool clear_filter = false;
+    if (this->file_list_)
+    {
+        const auto* const old_file_list = PTK_FILE_LIST_REINTERPRET(this->file_list_);
+        if (old_file_list->dir == this->dir_)
+        {
+            pattern = old_file_list->filter.pattern();
+        }
+        else
+        {
+            clear_filter = !old_file_list->filter.pattern().empty();
+        }
+    }
+
+    // file sorting settings
+    const ptk::file_list::sort_options options{
+        file_list_order_from_sort_order(this->sort_order_),
+        this->sort_type_,
+        ptk::file_list::sort_dir(
+            xset_get_int_panel(this->panel_, xset::panel::sort_extra, xset::var::y)),
+        xset_get_b_panel(this->panel_, xset::panel::sort_extra),
+        xset_get_int_panel(this->panel_, xset::panel::sort_extra, xset::var::x) ==
+            xset::set::enabled::yes,
+        xset_get_int_panel(this->panel_, xset::panel::sort_extra, xset::var::z) ==
+            xset::set::enabled::yes,
+        ptk::file_list::parse_sort_columns(
+            xset_get_s_panel(this->panel_, xset::panel::sort_extra).value_or(""))
+            .value_or(std::vector<ptk::file_list::sort_column>{}),
+    };
+
+    // going back to a directory reuses its already filtered and sorted list
     ptk::file_list* list =
-        ptk::file_list::create(this->dir_, this->show_hidden_files_, pattern.data());
-    assert(list != nullptr);
+        ptk::file_list_cache::take(this->dir_, this->show_hidden_files_, pattern, options);
+    if (!list)
+    {
+        list = ptk::file_list::create(this->dir_, this->show_hidden_files_, pattern);
+        assert(list != nullptr);
+
+        list->sort_natural = options.natural;
+        list->sort_case = options.case_sensitive;
+        list->sort_dir_ = options.dir;
+        list->sort_hidden_first = options.hidden_first;
+        list->sort_then = options.then;
+
+        gtk_tree_sortable_set_sort_column_id(GTK_TREE_SORTABLE(list),
+                                             magic_enum::enum_integer(options.column),
+                                             options.order);
+    }
+
     GtkTreeModel* old_list = this->file_list_;
     this->file_list_ = GTK_TREE_MODEL(list);
     if (old_list)
     {
-        g_object_unref(G_OBJECT(old_list));
-    }
+        g_signal_handlers_disconnect_by_func(G_OBJECT(old_list),
+                                             (void*)on_sort_col_changed,
+                                             this);
 
-    // set file sorting settings
-    list->sort_natural = xset_get_b_panel(this->panel_, xset::panel::sort_extra);
-    list->sort_case = xset_get_int_panel(this->panel_, xset::panel::sort_extra, xset::var::x) ==
-                      xset::set::enabled::yes;
-    list->sort_dir_ = ptk::file_list::sort_dir(
-        xset_get_int_panel(this->panel_, xset::panel::sort_extra, xset::var::y));
-    list->sort_hidden_first =
-        xset_get_int_panel(this->panel_, xset::panel::sort_extra, xset::var::z) ==
-        xset::set::enabled::yes;
+        // keep the list of the directory being left, a list
+        // of this directory is being rebuilt, i.e. show hidden files
+        if (PTK_FILE_LIST_REINTERPRET(old_list)->dir != this->dir_)
+        {
+            ptk::file_list_cache::put(PTK_FILE_LIST_REINTERPRET(old_list));
+        }
+        else
+        {
+            g_object_unref(G_OBJECT(old_list));
+        }
+    }
 
-    gtk_tree_sortable_set_sort_column_id(
-        GTK_TREE_SORTABLE(list),
-        magic_enum::enum_integer(file_list_order_from_sort_order(this->sort_order_)),
-        this->sort_type_);
+    if (clear_filter)
+    { // the search bar still shows the filter of the previous directory
+#if (GTK_MAJOR_VERSION == 4)
+        gtk_editable_set_text(GTK_EDITABLE(this->search_bar_), "");
+#elif (GTK_MAJOR_VERSION == 3)
+        gtk_entry_set_text(GTK_ENTRY(this->search_bar_), "");
+#endif
+    }
 
     this->show_thumbnails(this->max_thumbnail_);
 
@@ -1237,23 +1303,52 @@ ptk::browser::update_model(const std::string_view pattern) noexcept
     }
 }
 
+void
+ptk::browser::update_filter(const std::string_view pattern) noexcept
+{
+    if (!this->file_list_)
+    {
+        return;
+    }
+
+    ptk::file_list* list = PTK_FILE_LIST_REINTERPRET(this->file_list_);
+    if (list->virtual_dir)
+    { // rebuilding the rows is cheaper than a row signal for each of millions of entries
+        list->filter = ptk::file_filter(pattern);
+        this->update_model();
+    }
+    else
+    {
+        list->set_filter(pattern);
+    }
+
+    this->run_event<spacefm::signal::change_content>();
+}
+
 void
 ptk::browser::on_dir_file_listed() noexcept
 {
     this->n_selected_files_ = 0;
 
-    this->signal_file_created.disconnect();
+    this->signal_file_changes.disconnect();
     this->signal_file_deleted.disconnect();
     this->signal_file_changed.disconnect();
 
-    this->signal_file_created = this->dir_->add_event<spacefm::signal::file_created>(
-        std::bind(&ptk::browser::on_folder_content_changed, this, std::placeholders::_1));
+    this->signal_file_changes = this->dir_->add_event<spacefm::signal::file_changes>(
+        std::bind(&ptk::browser::on_folder_content_batch, this, std::placeholders::_1));
     this->signal_file_deleted = this->dir_->add_event<spacefm::signal::file_deleted>(
         std::bind(&ptk::browser::on_folder_content_changed, this, std::placeholders::_1));
     this->signal_file_changed = this->dir_->add_event<spacefm::signal::file_changed>(
         std::bind(&ptk::browser::on_folder_content_changed, this, std::placeholders::_1));
 
-    this->update_model();
+    // a directory found to be too large while streaming is listed by name only,
+    // the streamed model is replaced
+    if (!this->model_streamed_ ||
+        (this->dir_->is_virtual() && !PTK_FILE_LIST_REINTERPRET(this->file_list_)->virtual_dir))
+    {
+        this->update_model();
+    }
+    this->model_streamed_ = false;
 
     /* Ensuring free space at the end of the heap is freed to the OS,
      * mainly to deal with the possibility that changing the directory results in
@@ -1276,6 +1371,27 @@ ptk::browser::on_dir_file_listed() noexcept
     }
 }
 
+void
+ptk::browser::on_dir_file_listed_batch(
+    const std::span<const std::shared_ptr<vfs::file>> files) noexcept
+{
+    if (!this->model_streamed_)
+    {
+        // first batch, show what has been read so far.
+        // the model picks up these files from this->dir_->files()
+        this->update_model();
+        this->model_streamed_ = true;
+    }
+    else
+    {
+        ptk::file_list* list = PTK_FILE_LIST_REINTERPRET(this->file_list_);
+        list->add_files(files);
+    }
+
+    // update the loading progress in the status bar
+    this->run_event<spacefm::signal::change_content>();
+}
+
 /* signal handlers */
 
 static void
@@ -2942,12 +3058,16 @@ ptk::browser::chdir(const std::filesystem::path& new_path,
     // load new dir
 
     this->signal_file_listed.disconnect();
+    this->signal_file_listed_batch.disconnect();
+    this->model_streamed_ = false;
     this->dir_ = vfs::dir::create(path);
 
     this->run_event<spacefm::signal::chdir_begin>();
 
     this->signal_file_listed = this->dir_->add_event<spacefm::signal::file_listed>(
         std::bind(&ptk::browser::on_dir_file_listed, this));
+    this->signal_file_listed_batch = this->dir_->add_event<spacefm::signal::file_listed_batch>(
+        std::bind(&ptk::browser::on_dir_file_listed_batch, this, std::placeholders::_1));
     if (this->dir_->is_loaded())
     {
         // TODO - if the dir is loaded from cache then it will not run the file_listed signal.
@@ -3210,7 +3330,11 @@ ptk::browser::get_tab_panel_counts() const noexcept
 u64
 ptk::browser::get_n_all_files() const noexcept
 {
-    return this->dir_ ? this->dir_->files().size() : 0;
+    if (!this->dir_)
+    {
+        return 0;
+    }
+    return this->dir_->is_virtual() ? this->dir_->entries().size() : this->dir_->files().size();
 }
 
 u64
@@ -3357,6 +3481,7 @@ ptk::browser::refresh(const bool update_selected_files) noexcept
     }
 
     // destroy file list and create new one
+    ptk::file_list_cache::erase(this->dir_);
     this->update_model();
 
     /* Ensuring free space at the end of the heap is freed to the OS,
@@ -4089,6 +4214,29 @@ ptk::browser::set_sort_extra(xset::name setname) const noexcept
     list->sort();
 }
 
+bool
+ptk::browser::set_sort_then(const std::string_view spec) const noexcept
+{
+    const auto columns = ptk::file_list::parse_sort_columns(spec);
+    if (!columns)
+    {
+        return false;
+    }
+
+    xset_set_panel(this->panel_,
+                   xset::panel::sort_extra,
+                   xset::var::s,
+                   ptk::file_list::format_sort_columns(columns.value()));
+
+    ptk::file_list* list = PTK_FILE_LIST_REINTERPRET(this->file_list_);
+    if (list)
+    {
+        list->sort_then = columns.value();
+        list->sort();
+    }
+    return true;
+}
+
 void
 ptk::browser::paste_link() const noexcept
 {
@@ -5445,7 +5593,16 @@ ptk::browser::update_statusbar() const noexcept
     // Show Reading... while sill loading
     if (!this->dir_ || this->dir_->is_loading())
     {
-        statusbar_txt.append(std::format("Reading {} ...", cwd.string()));
+        if (this->dir_ && !this->dir_->is_directory_empty())
+        {
+            statusbar_txt.append(std::format("Reading {} ... ({:L} files)",
+                                             cwd.string(),
+                                             this->dir_->files().size()));
+        }
+        else
+        {
+            statusbar_txt.append(std::format("Reading {} ...", cwd.string()));
+        }
         gtk_statusbar_pop(this->statusbar, 0);
         gtk_statusbar_push(this->statusbar, 0, statusbar_txt.data());
         return;
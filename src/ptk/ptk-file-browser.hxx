@@ -107,6 +107,7 @@ struct browser
     u64 sel_size_{0};
     u64 sel_disk_size_{0};
     u32 sel_change_idle_{0};
+    bool model_streamed_{false}; // model was built from file_listed_batch while loading
 
     // path bar auto seek
     bool inhibit_focus_{false};
@@ -254,6 +255,9 @@ struct browser
     void set_sort_order(ptk::browser::sort_order order) noexcept;
     void set_sort_type(GtkSortType order) noexcept;
     void set_sort_extra(xset::name setname) const noexcept;
+    // secondary sort columns, see ptk::file_list::parse_sort_columns().
+    // returns false if spec is invalid.
+    [[nodiscard]] bool set_sort_then(const std::string_view spec) const noexcept;
 
     void paste_link() const noexcept;
     void paste_target() const noexcept;
@@ -304,10 +308,13 @@ struct browser
 
     ////////////////
 
+    // rebuild the file list model, keeping the current filter
+    void update_model() noexcept;
     /**
     * @param[in] pattern Only show files matching the pattern, an empty pattern shows all files.
+    * See ptk::file_filter for the pattern syntax.
     */
-    void update_model(const std::string_view pattern = "") noexcept;
+    void update_filter(const std::string_view pattern) noexcept;
 
     bool using_large_icons() const noexcept;
 
@@ -337,7 +344,9 @@ struct browser
   public:
     // signal
     void on_folder_content_changed(const std::shared_ptr<vfs::file>& file) noexcept;
+    void on_folder_content_batch(const vfs::dir::change_set& changes) noexcept;
     void on_dir_file_listed() noexcept;
+    void on_dir_file_listed_batch(const std::span<const std::shared_ptr<vfs::file>> files) noexcept;
 
     // Signals
   public:
@@ -469,10 +478,11 @@ struct browser
 
   public:
     // Signals we connect to
-    sigc::connection signal_file_created;
+    sigc::connection signal_file_changes;
     sigc::connection signal_file_deleted;
     sigc::connection signal_file_changed;
     sigc::connection signal_file_listed;
+    sigc::connection signal_file_listed_batch;
 };
 } // namespace ptk
 
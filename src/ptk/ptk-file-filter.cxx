@@ -0,0 +1,388 @@
+/**
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+#include <string_view>
+
+#include <vector>
+
+#include <algorithm>
+#include <ranges>
+
+#include <memory>
+
+#include <bit>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <fnmatch.h>
+
+#include <glib.h>
+
+#include <ztd/ztd.hxx>
+#include <ztd/ztd_logger.hxx>
+
+#include "ptk/natsort/natural.hxx"
+
+#include "ptk/ptk-file-filter.hxx"
+
+static constexpr std::string_view REGEX_PREFIX{"re:"};
+static constexpr std::string_view FUZZY_PREFIX{"~"};
+
+[[nodiscard]] static char
+to_upper(const char c) noexcept
+{
+    return (c >= 'a' && c <= 'z') ? static_cast<char>(c - ('a' - 'A')) : c;
+}
+
+#if defined(__SSE2__)
+[[nodiscard]] static __m128i
+to_upper(const __m128i chunk) noexcept
+{
+    // signed compares, bytes >= 0x80 are never in 'a'..'z'
+    const auto is_lower = _mm_and_si128(_mm_cmpgt_epi8(chunk, _mm_set1_epi8('a' - 1)),
+                                        _mm_cmplt_epi8(chunk, _mm_set1_epi8('z' + 1)));
+    return _mm_sub_epi8(chunk, _mm_and_si128(is_lower, _mm_set1_epi8('a' - 'A')));
+}
+#endif
+
+[[nodiscard]] static bool
+is_ascii(const std::string_view str) noexcept
+{
+    usize i = 0;
+#if defined(__SSE2__)
+    for (; i + 16 <= str.size(); i += 16)
+    {
+        const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str.data() + i));
+        if (_mm_movemask_epi8(chunk) != 0)
+        {
+            return false;
+        }
+    }
+#endif
+    return std::ranges::all_of(str.substr(i),
+                               [](const char c) { return static_cast<u8>(c) < 0x80; });
+}
+
+[[nodiscard]] static bool
+equal_at(const std::string_view haystack, const usize pos, const std::string_view needle,
+         const bool fold_case) noexcept
+{
+    if (!fold_case)
+    {
+        return haystack.substr(pos, needle.size()) == needle;
+    }
+    for (usize i = 0; i < needle.size(); ++i)
+    {
+        if (to_upper(haystack[pos + i]) != needle[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// does haystack contain needle. with fold_case ASCII letters in haystack are
+// upper cased, needle must already be upper cased.
+[[nodiscard]] static bool
+contains(const std::string_view haystack, const std::string_view needle,
+         const bool fold_case) noexcept
+{
+    if (needle.empty())
+    {
+        return true;
+    }
+    if (haystack.size() < needle.size())
+    {
+        return false;
+    }
+
+    const usize positions = haystack.size() - needle.size() + 1;
+    usize i = 0;
+#if defined(__SSE2__)
+    // test 16 positions at once for the first and last needle byte,
+    // only candidates that match both are compared in full.
+    const auto first = _mm_set1_epi8(needle.front());
+    const auto last = _mm_set1_epi8(needle.back());
+    for (; i + 16 <= positions; i += 16)
+    {
+        auto chunk_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack.data() + i));
+        auto chunk_last = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(haystack.data() + i + needle.size() - 1));
+        if (fold_case)
+        {
+            chunk_first = to_upper(chunk_first);
+            chunk_last = to_upper(chunk_last);
+        }
+
+        auto candidates = static_cast<u32>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(chunk_first, first), _mm_cmpeq_epi8(chunk_last, last))));
+        while (candidates != 0)
+        {
+            const auto pos = i + static_cast<usize>(std::countr_zero(candidates));
+            if (equal_at(haystack, pos, needle, fold_case))
+            {
+                return true;
+            }
+            candidates &= candidates - 1;
+        }
+    }
+#endif
+    for (; i < positions; ++i)
+    {
+        if (equal_at(haystack, i, needle, fold_case))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// are the characters of needle in haystack, in order
+[[nodiscard]] static bool
+is_subsequence(const std::string_view haystack, const std::string_view needle,
+               const bool fold_case) noexcept
+{
+    usize found = 0;
+    for (const char c : haystack)
+    {
+        if (found == needle.size())
+        {
+            break;
+        }
+        if ((fold_case ? to_upper(c) : c) == needle[found])
+        {
+            ++found;
+        }
+    }
+    return found == needle.size();
+}
+
+ptk::file_filter::file_filter(const std::string_view pattern) noexcept : pattern_(pattern)
+{
+    if (pattern.starts_with(REGEX_PREFIX))
+    {
+        this->mode_ = mode::regex;
+
+        const auto expression = std::string(pattern.substr(REGEX_PREFIX.size()));
+        if (expression.empty())
+        {
+            return;
+        }
+
+        GError* error = nullptr;
+        GRegex* regex = g_regex_new(expression.c_str(),
+                                    GRegexCompileFlags(G_REGEX_CASELESS | G_REGEX_OPTIMIZE),
+                                    GRegexMatchFlags(0),
+                                    &error);
+        if (!regex)
+        { // likely still being typed, match everything until it is valid
+            ztd::logger::debug("Invalid filter regex '{}': {}", expression, error->message);
+            g_error_free(error);
+            return;
+        }
+        this->regex_ = std::shared_ptr<GRegex>(regex, g_regex_unref);
+        return;
+    }
+
+    if (pattern.starts_with(FUZZY_PREFIX))
+    {
+        this->mode_ = mode::fuzzy;
+        this->fuzzy_ = ptk::natsort::fold(pattern.substr(FUZZY_PREFIX.size()));
+        return;
+    }
+
+    for (const auto part : std::views::split(pattern, ';'))
+    {
+        const auto text = std::string_view(part.begin(), part.end());
+        if (text.empty())
+        {
+            continue;
+        }
+
+        const auto is_glob = [](const std::string_view str)
+        { return str.find_first_of("*?[\\") != std::string_view::npos; };
+
+        if (!is_glob(text))
+        {
+            this->terms_.push_back({kind::substring, ptk::natsort::fold(text)});
+            continue;
+        }
+
+        // the common glob shapes are matched without fnmatch()
+        const bool leading_star = text.starts_with('*');
+        const bool trailing_star = text.size() > 1 && text.ends_with('*');
+        const auto literal = text.substr(leading_star ? 1 : 0,
+                                         text.size() - leading_star - trailing_star);
+        if (literal.empty() || is_glob(literal))
+        {
+            this->terms_.push_back({kind::glob, std::string(text)});
+        }
+        else if (leading_star && trailing_star)
+        {
+            this->terms_.push_back({kind::contains, std::string(literal)});
+        }
+        else if (leading_star)
+        {
+            this->terms_.push_back({kind::suffix, std::string(literal)});
+        }
+        else if (trailing_star)
+        {
+            this->terms_.push_back({kind::prefix, std::string(literal)});
+        }
+        else
+        {
+            this->terms_.push_back({kind::glob, std::string(text)});
+        }
+    }
+}
+
+const std::string&
+ptk::file_filter::pattern() const noexcept
+{
+    return this->pattern_;
+}
+
+bool
+ptk::file_filter::empty() const noexcept
+{
+    switch (this->mode_)
+    {
+        case mode::terms:
+            return this->terms_.empty();
+        case mode::fuzzy:
+            return this->fuzzy_.empty();
+        case mode::regex:
+            return this->regex_ == nullptr;
+    }
+    return true;
+}
+
+bool
+ptk::file_filter::match(const std::string_view name) const noexcept
+{
+    if (this->empty())
+    {
+        return true;
+    }
+
+    switch (this->mode_)
+    {
+        case mode::terms:
+            return std::ranges::any_of(this->terms_,
+                                       [name](const term& term) { return term.match(name); });
+        case mode::fuzzy:
+            if (is_ascii(name))
+            {
+                return is_subsequence(name, this->fuzzy_, true);
+            }
+            return is_subsequence(ptk::natsort::fold(name), this->fuzzy_, false);
+        case mode::regex:
+            if (!g_utf8_validate(name.data(), static_cast<isize>(name.size()), nullptr))
+            {
+                return false;
+            }
+            return g_regex_match_full(this->regex_.get(),
+                                      name.data(),
+                                      static_cast<isize>(name.size()),
+                                      0,
+                                      GRegexMatchFlags(0),
+                                      nullptr,
+                                      nullptr);
+    }
+    return true;
+}
+
+bool
+ptk::file_filter::narrows(const file_filter& other) const noexcept
+{
+    if (other.empty() || this->pattern_ == other.pattern_)
+    {
+        return true;
+    }
+    if (this->empty() || this->mode_ != other.mode_)
+    {
+        return false;
+    }
+
+    switch (this->mode_)
+    {
+        case mode::terms:
+            // every term is narrower than a term of the other filter
+            return std::ranges::all_of(
+                this->terms_,
+                [&other](const term& term)
+                {
+                    return std::ranges::any_of(other.terms_,
+                                               [&term](const auto& o) { return term.narrows(o); });
+                });
+        case mode::fuzzy:
+            return is_subsequence(this->fuzzy_, other.fuzzy_, false);
+        case mode::regex:
+            break;
+    }
+    return false;
+}
+
+bool
+ptk::file_filter::term::match(const std::string_view name) const noexcept
+{
+    switch (this->type)
+    {
+        case kind::substring:
+            if (is_ascii(name))
+            { // ASCII names are folded while searching
+                return contains(name, this->text, true);
+            }
+            return contains(ptk::natsort::fold(name), this->text, false);
+        case kind::prefix:
+            return name.starts_with(this->text);
+        case kind::suffix:
+            return name.ends_with(this->text);
+        case kind::contains:
+            return contains(name, this->text, false);
+        case kind::glob:
+            return fnmatch(this->text.c_str(), std::string(name).c_str(), 0) == 0;
+    }
+    return false;
+}
+
+bool
+ptk::file_filter::term::narrows(const term& other) const noexcept
+{
+    if (this->type == other.type && this->text == other.text)
+    {
+        return true;
+    }
+
+    switch (other.type)
+    {
+        case kind::substring:
+            return this->type == kind::substring && this->text.contains(other.text);
+        case kind::prefix:
+            return this->type == kind::prefix && this->text.starts_with(other.text);
+        case kind::suffix:
+            return this->type == kind::suffix && this->text.ends_with(other.text);
+        case kind::contains:
+            return (this->type == kind::contains || this->type == kind::prefix ||
+                    this->type == kind::suffix) &&
+                   this->text.contains(other.text);
+        case kind::glob:
+            break;
+    }
+    return false;
+}
@@ -0,0 +1,90 @@
+/**
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include <vector>
+
+#include <memory>
+
+#include <glib.h>
+
+#include <ztd/ztd.hxx>
+
+namespace ptk
+{
+/**
+ * File name filter, compiled once from the pattern typed into the search bar.
+ *
+ * Pattern syntax:
+ *  - 're:' prefix, a case insensitive regular expression
+ *  - '~' prefix, fuzzy, the characters of the pattern appear in order, case insensitive
+ *  - otherwise ';' separated terms, a name matches if any term matches.
+ *    A term containing '*', '?' or '[' is a glob, matched like fnmatch().
+ *    Any other term matches as a case insensitive substring.
+ *
+ * An empty pattern matches every name.
+ */
+struct file_filter
+{
+    file_filter() = default;
+    file_filter(const std::string_view pattern) noexcept;
+
+    [[nodiscard]] const std::string& pattern() const noexcept;
+    [[nodiscard]] bool empty() const noexcept;
+
+    [[nodiscard]] bool match(const std::string_view name) const noexcept;
+
+    // every name this filter matches is also matched by other,
+    // i.e. the pattern has only been typed further.
+    [[nodiscard]] bool narrows(const file_filter& other) const noexcept;
+
+  private:
+    enum class mode
+    {
+        terms,
+        fuzzy,
+        regex,
+    };
+
+    enum class kind
+    {
+        substring, // case folded with natsort::fold()
+        prefix,    // glob 'text*'
+        suffix,    // glob '*text'
+        contains,  // glob '*text*'
+        glob,      // anything else, uses fnmatch()
+    };
+
+    struct term
+    {
+        kind type;
+        std::string text;
+
+        [[nodiscard]] bool match(const std::string_view name) const noexcept;
+        [[nodiscard]] bool narrows(const term& other) const noexcept;
+    };
+
+    std::string pattern_;
+    mode mode_{mode::terms};
+
+    std::vector<term> terms_;
+    std::string fuzzy_; // case folded with natsort::fold()
+    std::shared_ptr<GRegex> regex_{nullptr};
+};
+} // namespace ptk
@@ -0,0 +1,111 @@
+/**
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <string_view>
+
+#include <list>
+
+#include <algorithm>
+
+#include <memory>
+
+#include <glib-object.h>
+
+#include <ztd/ztd.hxx>
+
+#include "settings/settings.hxx"
+
+#include "vfs/vfs-dir.hxx"
+
+#include "ptk/ptk-file-list.hxx"
+
+#include "ptk/ptk-file-list-cache.hxx"
+
+namespace global
+{
+// most recently left at the front, the cache owns one reference to each list
+std::list<ptk::file_list*> file_list_cache;
+} // namespace global
+
+static void
+trim() noexcept
+{
+    while (global::file_list_cache.size() > config::settings.file_list_cache_size)
+    {
+        g_object_unref(G_OBJECT(global::file_list_cache.back()));
+        global::file_list_cache.pop_back();
+    }
+}
+
+ptk::file_list*
+ptk::file_list_cache::take(const std::shared_ptr<vfs::dir>& dir, const bool show_hidden,
+                           const std::string_view pattern,
+                           const ptk::file_list::sort_options& options) noexcept
+{
+    const auto is_match = [&](const ptk::file_list* list)
+    {
+        return list->dir == dir && list->show_hidden == show_hidden &&
+               list->filter.pattern() == pattern && list->current_sort_options() == options;
+    };
+
+    const auto it = std::ranges::find_if(global::file_list_cache, is_match);
+    if (it == global::file_list_cache.cend())
+    {
+        return nullptr;
+    }
+
+    ptk::file_list* list = *it;
+    global::file_list_cache.erase(it);
+    return list;
+}
+
+void
+ptk::file_list_cache::put(ptk::file_list* list) noexcept
+{
+    const auto& dir = list->dir;
+    if (!dir || dir->is_loading() || dir->is_virtual() || dir->avoid_changes())
+    {
+        g_object_unref(G_OBJECT(list));
+        return;
+    }
+
+    global::file_list_cache.push_front(list);
+    trim();
+}
+
+void
+ptk::file_list_cache::erase(const std::shared_ptr<vfs::dir>& dir) noexcept
+{
+    std::erase_if(global::file_list_cache,
+                  [&dir](ptk::file_list* list)
+                  {
+                      if (list->dir != dir)
+                      {
+                          return false;
+                      }
+                      g_object_unref(G_OBJECT(list));
+                      return true;
+                  });
+}
+
+void
+ptk::file_list_cache::clear() noexcept
+{
+    for (ptk::file_list* list : global::file_list_cache)
+    {
+        g_object_unref(G_OBJECT(list));
+    }
+    global::file_list_cache.clear();
+}
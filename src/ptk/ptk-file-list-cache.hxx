@@ -0,0 +1,55 @@
+/**
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <string_view>
+
+#include <memory>
+
+#include "vfs/vfs-dir.hxx"
+
+#include "ptk/ptk-file-list.hxx"
+
+/**
+ * Keeps the sorted and filtered ptk::file_list of recently left
+ * directories, so that going back to a directory or opening it in
+ * another tab does not have to filter and sort every file again.
+ *
+ * Cached lists stay connected to their vfs::dir and follow its changes,
+ * which also keeps the vfs::dir loaded, see vfs::dir_cache.
+ * Only lists that are not shown are held, at most
+ * config::settings.file_list_cache_size of them, least recently left
+ * lists are dropped first. Main loop only.
+ */
+namespace ptk::file_list_cache
+{
+// take the cached list for dir with these settings, nullptr if there is none.
+// the list is removed from the cache and the caller owns the reference.
+[[nodiscard]] ptk::file_list* take(const std::shared_ptr<vfs::dir>& dir, const bool show_hidden,
+                                   const std::string_view pattern,
+                                   const ptk::file_list::sort_options& options) noexcept;
+
+// keep a list that is no longer shown, takes over the callers reference.
+// lists of directories that are not fully loaded, not monitored for
+// changes, or listed by name only are released instead.
+void put(ptk::file_list* list) noexcept;
+
+// drop every cached list for dir
+void erase(const std::shared_ptr<vfs::dir>& dir) noexcept;
+
+// drop every cached list
+void clear() noexcept;
+} // namespace ptk::file_list_cache
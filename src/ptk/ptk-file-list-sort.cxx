@@ -0,0 +1,754 @@
+/**
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+#include <string_view>
+
+#include <filesystem>
+
+#include <span>
+
+#include <vector>
+
+#include <algorithm>
+#include <ranges>
+
+#include <chrono>
+
+#include <memory>
+
+#include <optional>
+
+#include <thread>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <magic_enum.hpp>
+
+#include <ztd/ztd.hxx>
+
+#include "concurrency.hxx"
+
+#include "vfs/vfs-file.hxx"
+
+#include "vfs/linux/dirent.hxx"
+
+#include "ptk/natsort/natural.hxx"
+
+#include "ptk/ptk-file-list.hxx"
+
+// below this many files splitting the sort across threads costs more than it saves
+static constexpr usize PARALLEL_SORT_THRESHOLD{64 * 1024};
+static constexpr usize PARALLEL_SORT_MIN_CHUNK{16 * 1024};
+
+namespace
+{
+// how the keys of a column are compared
+enum class key_kind
+{
+    number,  // sort_key::number
+    text,    // sort_key::text, byte order
+    natural, // sort_key::text, natural order
+    rank,    // sort_key::text, but few distinct values, compared by their rank
+};
+
+// a flat copy of a sort_key, this is what is actually sorted
+struct entry
+{
+    u32 group;
+    u32 rank;
+    i64 number;
+    const std::string* text;
+    const ptk::file_list::sort_key* key; // for ties
+    u32 index;                           // position in the unsorted list
+};
+} // namespace
+
+static key_kind
+column_key_kind(const ptk::file_list::column column, const bool natural) noexcept
+{
+    switch (column)
+    {
+        case ptk::file_list::column::name:
+            return natural ? key_kind::natural : key_kind::text;
+        case ptk::file_list::column::size:
+        case ptk::file_list::column::bytes:
+        case ptk::file_list::column::atime:
+        case ptk::file_list::column::btime:
+        case ptk::file_list::column::ctime:
+        case ptk::file_list::column::mtime:
+            return key_kind::number;
+        case ptk::file_list::column::type:
+        case ptk::file_list::column::mime:
+        case ptk::file_list::column::perm:
+        case ptk::file_list::column::owner:
+        case ptk::file_list::column::group:
+            return key_kind::rank;
+        case ptk::file_list::column::big_icon:
+        case ptk::file_list::column::small_icon:
+        case ptk::file_list::column::info:
+            break;
+    }
+    return key_kind::text;
+}
+
+static i64
+time_key(const std::chrono::system_clock::time_point time) noexcept
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+// the number or text a column is sorted by
+static void
+make_column_key(const std::shared_ptr<vfs::file>& file, const ptk::file_list::column column,
+                const ptk::file_list::sort_options& options, i64& number,
+                std::string& text) noexcept
+{
+    switch (column)
+    {
+        case ptk::file_list::column::name:
+            if (options.natural && !options.case_sensitive)
+            { // fold once here instead of in every natsort::compare_icase()
+                text = ptk::natsort::fold(file->name());
+            }
+            else
+            {
+                text = file->name();
+            }
+            break;
+        case ptk::file_list::column::size:
+        case ptk::file_list::column::bytes:
+            number = static_cast<i64>(file->size());
+            break;
+        case ptk::file_list::column::type:
+            text = file->mime_type()->description();
+            break;
+        case ptk::file_list::column::mime:
+            text = file->mime_type()->type();
+            break;
+        case ptk::file_list::column::perm:
+            text = file->display_permissions();
+            break;
+        case ptk::file_list::column::owner:
+            text = file->display_owner();
+            break;
+        case ptk::file_list::column::group:
+            text = file->display_group();
+            break;
+        case ptk::file_list::column::atime:
+            number = time_key(file->atime());
+            break;
+        case ptk::file_list::column::btime:
+            number = time_key(file->btime());
+            break;
+        case ptk::file_list::column::ctime:
+            number = time_key(file->ctime());
+            break;
+        case ptk::file_list::column::mtime:
+            number = time_key(file->mtime());
+            break;
+        case ptk::file_list::column::big_icon:
+        case ptk::file_list::column::small_icon:
+        case ptk::file_list::column::info:
+            break;
+    }
+}
+
+ptk::file_list::sort_key
+ptk::file_list::make_sort_key(const std::shared_ptr<vfs::file>& file,
+                              const sort_options& options) noexcept
+{
+    sort_key key;
+    key.name = file->name();
+
+    // directories first/last, then hidden first/last. neither is reversed by the sort order.
+    if (options.dir != ptk::file_list::sort_dir::mixed)
+    {
+        const bool is_dir = file->is_directory();
+        key.group = (options.dir == ptk::file_list::sort_dir::first ? !is_dir : is_dir) << 1;
+    }
+    const bool is_hidden = file->is_hidden();
+    key.group |= options.hidden_first ? !is_hidden : is_hidden;
+
+    make_column_key(file, options.column, options, key.number, key.text);
+
+    key.then.resize(options.then.size());
+    for (usize index = 0; index < options.then.size(); ++index)
+    {
+        make_column_key(file,
+                        options.then[index].column,
+                        options,
+                        key.then[index].number,
+                        key.then[index].text);
+    }
+
+    return key;
+}
+
+static i32
+compare_numbers(const i64 a, const i64 b) noexcept
+{
+    return (a > b) - (a < b);
+}
+
+static i32
+compare_column_keys(const key_kind kind, const GtkSortType order, const i64 a_number,
+                    const std::string& a_text, const i64 b_number,
+                    const std::string& b_text) noexcept
+{
+    i32 result = 0;
+    switch (kind)
+    {
+        case key_kind::number:
+            result = compare_numbers(a_number, b_number);
+            break;
+        case key_kind::natural:
+            result = ptk::natsort::compare(a_text, b_text);
+            break;
+        case key_kind::text:
+        case key_kind::rank:
+            result = a_text.compare(b_text);
+            break;
+    }
+
+    return order == GtkSortType::GTK_SORT_ASCENDING ? result : -result;
+}
+
+// compare keys that are equal in the main column, by the secondary columns then the name
+static i32
+compare_tied_keys(const ptk::file_list::sort_key& a, const ptk::file_list::sort_key& b,
+                  const ptk::file_list::sort_options& options) noexcept
+{
+    // keys made without secondary columns, see make_entry_sort_key()
+    const usize count = std::min({options.then.size(), a.then.size(), b.then.size()});
+    for (usize index = 0; index < count; ++index)
+    {
+        const auto& then = options.then[index];
+        const i32 result = compare_column_keys(column_key_kind(then.column, options.natural),
+                                               then.order,
+                                               a.then[index].number,
+                                               a.then[index].text,
+                                               b.then[index].number,
+                                               b.then[index].text);
+        if (result != 0)
+        {
+            return result;
+        }
+    }
+
+    return a.name.compare(b.name);
+}
+
+i32
+ptk::file_list::compare_sort_keys(const sort_key& a, const sort_key& b,
+                                  const sort_options& options) noexcept
+{
+    if (a.group != b.group)
+    {
+        return a.group < b.group ? -1 : 1;
+    }
+
+    const i32 result = compare_column_keys(column_key_kind(options.column, options.natural),
+                                           options.order,
+                                           a.number,
+                                           a.text,
+                                           b.number,
+                                           b.text);
+    if (result != 0)
+    {
+        return result;
+    }
+
+    return compare_tied_keys(a, b, options);
+}
+
+// sort chunks on the thread pool, then merge neighbouring runs
+// in parallel until a single run is left.
+template<typename less_function>
+static void
+parallel_sort(std::vector<entry>& entries, const less_function& less) noexcept
+{
+    const usize workers = std::max(std::thread::hardware_concurrency(), 1u);
+    const usize chunks = std::min(workers, entries.size() / PARALLEL_SORT_MIN_CHUNK);
+    if (chunks <= 1)
+    {
+        std::ranges::stable_sort(entries, less);
+        return;
+    }
+
+    const auto pool = global::runtime.thread_pool_executor();
+
+    // run i is [bounds[i], bounds[i + 1])
+    std::vector<usize> bounds;
+    for (usize chunk = 0; chunk < chunks; ++chunk)
+    {
+        bounds.push_back(entries.size() * chunk / chunks);
+    }
+    bounds.push_back(entries.size());
+
+    {
+        const std::span<entry> all_entries = entries;
+        std::vector<concurrencpp::result<void>> results;
+        for (usize run = 0; run + 1 < bounds.size(); ++run)
+        {
+            const auto run_entries =
+                all_entries.subspan(bounds[run], bounds[run + 1] - bounds[run]);
+            results.push_back(pool->submit(
+                [&less, run_entries] { std::ranges::stable_sort(run_entries, less); }));
+        }
+        for (auto& result : results)
+        {
+            result.get();
+        }
+    }
+
+    std::vector<entry> buffer(entries.size());
+    while (bounds.size() > 2)
+    {
+        const usize runs = bounds.size() - 1;
+
+        std::vector<usize> merged_bounds;
+        std::vector<concurrencpp::result<void>> results;
+        for (usize run = 0; run < runs; run += 2)
+        {
+            const auto first = bounds[run];
+            const auto middle = bounds[run + 1];
+            // an odd run out is merged with nothing, which copies it
+            const auto last = run + 2 <= runs ? bounds[run + 2] : middle;
+
+            merged_bounds.push_back(first);
+            results.push_back(pool->submit(
+                [&entries, &buffer, &less, first, middle, last]
+                {
+                    std::merge(entries.cbegin() + first,
+                               entries.cbegin() + middle,
+                               entries.cbegin() + middle,
+                               entries.cbegin() + last,
+                               buffer.begin() + first,
+                               less);
+                }));
+        }
+        merged_bounds.push_back(entries.size());
+
+        for (auto& result : results)
+        {
+            result.get();
+        }
+
+        std::swap(entries, buffer);
+        bounds = std::move(merged_bounds);
+    }
+}
+
+// the group is never reversed, only the column order is.
+// ties in the main column are broken by the secondary columns and the name.
+template<typename compare_function>
+static void
+sort_entries(std::vector<entry>& entries, const ptk::file_list::sort_options& options,
+             const compare_function& compare) noexcept
+{
+    const bool descending = options.order != GtkSortType::GTK_SORT_ASCENDING;
+    const auto less = [descending, &options, &compare](const entry& a, const entry& b)
+    {
+        if (a.group != b.group)
+        {
+            return a.group < b.group;
+        }
+        const i32 result = compare(a, b);
+        if (result == 0)
+        {
+            return compare_tied_keys(*a.key, *b.key, options) < 0;
+        }
+        return descending ? result > 0 : result < 0;
+    };
+
+    if (entries.size() >= PARALLEL_SORT_THRESHOLD)
+    {
+        parallel_sort(entries, less);
+    }
+    else
+    {
+        std::ranges::stable_sort(entries, less);
+    }
+}
+
+// sort entries made from sort keys, entry::index maps each back to its source
+static void
+sort_keyed_entries(std::vector<entry>& entries, const key_kind kind,
+                   const ptk::file_list::sort_options& options) noexcept
+{
+    if (kind == key_kind::rank)
+    { // columns like type or owner have few distinct values, rank them once
+        std::vector<std::string_view> values;
+        values.reserve(entries.size());
+        for (const auto& e : entries)
+        {
+            values.push_back(*e.text);
+        }
+        std::ranges::sort(values);
+        const auto [first, last] = std::ranges::unique(values);
+        values.erase(first, last);
+
+        for (auto& e : entries)
+        {
+            e.rank = static_cast<u32>(std::ranges::lower_bound(values, *e.text) - values.cbegin());
+        }
+    }
+
+    // the comparison is chosen once per sort, not per compare
+    switch (kind)
+    {
+        case key_kind::number:
+            sort_entries(entries,
+                         options,
+                         [](const entry& a, const entry& b)
+                         { return compare_numbers(a.number, b.number); });
+            break;
+        case key_kind::rank:
+            sort_entries(entries,
+                         options,
+                         [](const entry& a, const entry& b)
+                         { return compare_numbers(a.rank, b.rank); });
+            break;
+        case key_kind::natural:
+            sort_entries(entries,
+                         options,
+                         [](const entry& a, const entry& b)
+                         { return ptk::natsort::compare(*a.text, *b.text); });
+            break;
+        case key_kind::text:
+            sort_entries(entries,
+                         options,
+                         [](const entry& a, const entry& b) { return a.text->compare(*b.text); });
+            break;
+    }
+}
+
+void
+ptk::file_list::sort_files(std::vector<std::shared_ptr<vfs::file>>& files,
+                           sort_key_cache& keys) noexcept
+{
+    const auto& options = keys.options();
+
+    std::vector<entry> entries;
+    entries.reserve(files.size());
+    for (usize index = 0; index < files.size(); ++index)
+    {
+        const auto& key = keys.get(files[index]);
+        entries.push_back({key.group, 0, key.number, &key.text, &key, static_cast<u32>(index)});
+    }
+
+    sort_keyed_entries(entries, column_key_kind(options.column, options.natural), options);
+
+    std::vector<std::shared_ptr<vfs::file>> sorted;
+    sorted.reserve(files.size());
+    for (const auto& e : entries)
+    {
+        sorted.push_back(std::move(files[e.index]));
+    }
+    files = std::move(sorted);
+}
+
+static bool
+column_needs_stat(const ptk::file_list::column column) noexcept
+{
+    switch (column)
+    {
+        case ptk::file_list::column::size:
+        case ptk::file_list::column::bytes:
+        case ptk::file_list::column::perm:
+        case ptk::file_list::column::owner:
+        case ptk::file_list::column::group:
+        case ptk::file_list::column::atime:
+        case ptk::file_list::column::btime:
+        case ptk::file_list::column::ctime:
+        case ptk::file_list::column::mtime:
+            return true;
+        case ptk::file_list::column::name:
+        case ptk::file_list::column::type:
+        case ptk::file_list::column::mime:
+        case ptk::file_list::column::big_icon:
+        case ptk::file_list::column::small_icon:
+        case ptk::file_list::column::info:
+            break;
+    }
+    return false;
+}
+
+static i64
+statx_time_key(const struct ::statx_timestamp& time) noexcept
+{
+    return (time.tv_sec * 1'000'000'000) + time.tv_nsec;
+}
+
+// the key of a dir entry, without a vfs::file. permissions, owner and group
+// are sorted by their numeric value instead of the displayed text.
+// secondary columns are not used, ties are only broken by the name.
+static ptk::file_list::sort_key
+make_entry_sort_key(const vfs::linux::dirent::entry& dir_entry, const struct ::statx* stat,
+                    const ptk::file_list::sort_options& options) noexcept
+{
+    ptk::file_list::sort_key key;
+    key.name = dir_entry.name;
+
+    if (options.dir != ptk::file_list::sort_dir::mixed)
+    {
+        const bool is_dir = dir_entry.type == DT_UNKNOWN && stat != nullptr
+                                ? S_ISDIR(stat->stx_mode)
+                                : dir_entry.type == DT_DIR;
+        key.group = (options.dir == ptk::file_list::sort_dir::first ? !is_dir : is_dir) << 1;
+    }
+    const bool is_hidden = dir_entry.name.starts_with('.');
+    key.group |= options.hidden_first ? !is_hidden : is_hidden;
+
+    if (stat == nullptr)
+    {
+        if (options.natural && !options.case_sensitive)
+        {
+            key.text = ptk::natsort::fold(dir_entry.name);
+        }
+        else
+        {
+            key.text = dir_entry.name;
+        }
+        return key;
+    }
+
+    switch (options.column)
+    {
+        case ptk::file_list::column::size:
+        case ptk::file_list::column::bytes:
+            key.number = static_cast<i64>(stat->stx_size);
+            break;
+        case ptk::file_list::column::perm:
+            key.number = stat->stx_mode;
+            break;
+        case ptk::file_list::column::owner:
+            key.number = stat->stx_uid;
+            break;
+        case ptk::file_list::column::group:
+            key.number = stat->stx_gid;
+            break;
+        case ptk::file_list::column::atime:
+            key.number = statx_time_key(stat->stx_atime);
+            break;
+        case ptk::file_list::column::btime:
+            key.number = statx_time_key(stat->stx_btime);
+            break;
+        case ptk::file_list::column::ctime:
+            key.number = statx_time_key(stat->stx_ctime);
+            break;
+        case ptk::file_list::column::mtime:
+            key.number = statx_time_key(stat->stx_mtime);
+            break;
+        case ptk::file_list::column::name:
+        case ptk::file_list::column::type:
+        case ptk::file_list::column::mime:
+        case ptk::file_list::column::big_icon:
+        case ptk::file_list::column::small_icon:
+        case ptk::file_list::column::info:
+            break;
+    }
+
+    return key;
+}
+
+void
+ptk::file_list::sort_entry_rows(std::vector<u32>& rows,
+                                const std::span<const vfs::linux::dirent::entry> entries,
+                                const std::filesystem::path& path,
+                                const sort_options& options) noexcept
+{
+    const bool needs_stat = column_needs_stat(options.column);
+
+    std::vector<sort_key> keys(rows.size());
+    const auto make_keys = [&rows, &entries, &keys, &options, needs_stat](const i32 dirfd,
+                                                                          const usize begin,
+                                                                          const usize end)
+    {
+        for (usize row = begin; row < end; ++row)
+        {
+            const auto& dir_entry = entries[rows[row]];
+
+            struct ::statx stat{};
+            const bool stated = needs_stat && ::statx(dirfd,
+                                                      dir_entry.name.c_str(),
+                                                      AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT,
+                                                      vfs::linux::dirent::statx_mask,
+                                                      &stat) == 0;
+            // a file deleted since the directory was read sorts as empty
+            keys[row] = make_entry_sort_key(dir_entry, stated ? &stat : nullptr, options);
+        }
+    };
+
+    if (needs_stat)
+    { // one statx() per entry, relative to the dir and spread over the thread pool
+        const i32 dirfd = open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+        const usize workers = std::max(std::thread::hardware_concurrency(), 1u);
+        const usize chunks = std::clamp(rows.size() / PARALLEL_SORT_MIN_CHUNK, usize{1}, workers);
+
+        const auto pool = global::runtime.thread_pool_executor();
+        std::vector<concurrencpp::result<void>> results;
+        for (usize chunk = 0; chunk < chunks; ++chunk)
+        {
+            const auto begin = rows.size() * chunk / chunks;
+            const auto end = rows.size() * (chunk + 1) / chunks;
+            results.push_back(
+                pool->submit([&make_keys, dirfd, begin, end] { make_keys(dirfd, begin, end); }));
+        }
+        for (auto& result : results)
+        {
+            result.get();
+        }
+
+        if (dirfd != -1)
+        {
+            close(dirfd);
+        }
+    }
+    else
+    {
+        make_keys(-1, 0, rows.size());
+    }
+
+    // type and mime need a vfs::file, every other column is either a number or the name
+    const auto kind = needs_stat ? key_kind::number
+                                 : (options.natural ? key_kind::natural : key_kind::text);
+
+    std::vector<entry> sorted;
+    sorted.reserve(rows.size());
+    for (usize row = 0; row < rows.size(); ++row)
+    {
+        const auto& key = keys[row];
+        sorted.push_back({key.group, 0, key.number, &key.text, &key, static_cast<u32>(row)});
+    }
+
+    sort_keyed_entries(sorted, kind, options);
+
+    std::vector<u32> sorted_rows;
+    sorted_rows.reserve(rows.size());
+    for (const auto& e : sorted)
+    {
+        sorted_rows.push_back(rows[e.index]);
+    }
+    rows = std::move(sorted_rows);
+}
+
+std::optional<std::vector<ptk::file_list::sort_column>>
+ptk::file_list::parse_sort_columns(const std::string_view spec) noexcept
+{
+    std::vector<sort_column> columns;
+    for (const auto part : std::views::split(spec, ','))
+    {
+        std::string_view item(part.begin(), part.end());
+        if (item.empty())
+        {
+            continue;
+        }
+
+        sort_column column;
+        const auto separator = item.find(':');
+        if (separator != std::string_view::npos)
+        {
+            const auto order = item.substr(separator + 1);
+            if (order == "desc")
+            {
+                column.order = GtkSortType::GTK_SORT_DESCENDING;
+            }
+            else if (order != "asc")
+            {
+                return std::nullopt;
+            }
+            item = item.substr(0, separator);
+        }
+
+        const auto name = magic_enum::enum_cast<ptk::file_list::column>(item);
+        if (!name || name.value() == ptk::file_list::column::big_icon ||
+            name.value() == ptk::file_list::column::small_icon ||
+            name.value() == ptk::file_list::column::info)
+        {
+            return std::nullopt;
+        }
+        column.column = name.value();
+
+        columns.push_back(column);
+    }
+    return columns;
+}
+
+std::string
+ptk::file_list::format_sort_columns(const std::span<const sort_column> columns) noexcept
+{
+    std::string spec;
+    for (const auto& column : columns)
+    {
+        if (!spec.empty())
+        {
+            spec.push_back(',');
+        }
+        spec.append(magic_enum::enum_name(column.column));
+        if (column.order == GtkSortType::GTK_SORT_DESCENDING)
+        {
+            spec.append(":desc");
+        }
+    }
+    return spec;
+}
+
+// sort_key_cache
+
+const ptk::file_list::sort_key&
+ptk::file_list::sort_key_cache::get(const std::shared_ptr<vfs::file>& file) noexcept
+{
+    const auto it = this->keys_.find(file.get());
+    if (it != this->keys_.cend())
+    {
+        return it->second;
+    }
+    return this->keys_.emplace(file.get(), make_sort_key(file, this->options_)).first->second;
+}
+
+void
+ptk::file_list::sort_key_cache::erase(const vfs::file* file) noexcept
+{
+    this->keys_.erase(file);
+}
+
+void
+ptk::file_list::sort_key_cache::clear() noexcept
+{
+    this->keys_.clear();
+}
+
+const ptk::file_list::sort_options&
+ptk::file_list::sort_key_cache::options() const noexcept
+{
+    return this->options_;
+}
+
+void
+ptk::file_list::sort_key_cache::set_options(const sort_options& options) noexcept
+{
+    if (this->options_ == options)
+    {
+        return;
+    }
+    this->options_ = options;
+    this->keys_.clear();
+}
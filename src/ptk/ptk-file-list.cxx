@@ -17,27 +17,28 @@
 
 #include <string_view>
 
+#include <span>
+
+#include <vector>
+
 #include <algorithm>
+#include <ranges>
 
 #include <chrono>
 
 #include <functional>
 
-#include <cassert>
-#include <cstring>
+#include <memory>
 
-#include <fnmatch.h>
+#include <cassert>
 
 #include <magic_enum.hpp>
 
 #include <ztd/ztd.hxx>
 #include <ztd/ztd_logger.hxx>
 
-#include "compat/type-conversion.hxx"
-
 #include "vfs/vfs-file.hxx"
 
-#include "ptk/natsort/strnatcmp.hxx"
 #include "ptk/utils/ptk-utils.hxx"
 
 #include "ptk/ptk-file-list.hxx"
@@ -95,6 +96,10 @@ static void ptk_file_list_set_default_sort_func(GtkTreeSortable* sortable,
 
 static GObjectClass* parent_class = nullptr;
 
+// fewer created files than this are inserted one by one,
+// more are sorted and merged into the list in a single pass.
+static constexpr usize INSERT_MERGE_THRESHOLD{64};
+
 namespace global
 {
 const ztd::map<ptk::file_list::column, GType, 15> column_types{{{
@@ -168,7 +173,14 @@ ptk_file_list_get_type() noexcept
 static void
 ptk_file_list_init(ptk::file_list* list) noexcept
 {
-    list->files = nullptr;
+    // GObject memory is zeroed, not constructed
+    new (&list->files) std::vector<std::shared_ptr<vfs::file>>();
+    new (&list->rows) std::unordered_map<const vfs::file*, u32>();
+    new (&list->sort_keys) ptk::file_list::sort_key_cache();
+    new (&list->entry_rows) std::vector<u32>();
+    new (&list->entry_positions) std::vector<u32>();
+    new (&list->sort_then) std::vector<ptk::file_list::sort_column>();
+    new (&list->filter) ptk::file_filter();
     list->sort_order = (GtkSortType)-1;
     list->sort_col = ptk::file_list::column::name;
     list->stamp = ptk::utils::stamp();
@@ -233,6 +245,13 @@ ptk_file_list_finalize(GObject* object) noexcept
     ptk::file_list* list = PTK_FILE_LIST_REINTERPRET(object);
 
     list->set_dir(nullptr);
+    std::destroy_at(&list->files);
+    std::destroy_at(&list->rows);
+    std::destroy_at(&list->sort_keys);
+    std::destroy_at(&list->entry_rows);
+    std::destroy_at(&list->entry_positions);
+    std::destroy_at(&list->sort_then);
+    std::destroy_at(&list->filter);
     /* must chain up - finalize parent */
     (*parent_class->finalize)(object);
 }
@@ -243,19 +262,153 @@ ptk::file_list::create(const std::shared_ptr<vfs::dir>& dir, const bool show_hid
 {
     ptk::file_list* list = PTK_FILE_LIST(g_object_new(PTK_TYPE_FILE_LIST, nullptr));
     list->show_hidden = show_hidden;
-    list->pattern = pattern.data();
+    list->filter = ptk::file_filter(pattern);
     list->set_dir(dir);
     return list;
 }
 
 bool
-ptk::file_list::is_pattern_match(const std::filesystem::path& filename) const noexcept
+ptk::file_list::is_pattern_match(const std::string_view filename) const noexcept
+{
+    return this->filter.match(filename);
+}
+
+void
+ptk::file_list::set_filter(const std::string_view pattern) noexcept
+{
+    if (pattern == this->filter.pattern())
+    {
+        return;
+    }
+
+    ptk::file_filter filter(pattern);
+    // typing further only hides rows, deleting characters only shows rows
+    const bool narrower = filter.narrows(this->filter);
+    const bool wider = this->filter.narrows(filter);
+    this->filter = std::move(filter);
+
+    if (!this->dir)
+    {
+        return;
+    }
+
+    if (!wider)
+    {
+        std::vector<std::shared_ptr<vfs::file>> hidden;
+        for (const auto& file : this->files)
+        {
+            if (!this->is_pattern_match(file->name()))
+            {
+                hidden.push_back(file);
+            }
+        }
+        this->remove_files(hidden);
+    }
+
+    if (!narrower)
+    {
+        std::vector<std::shared_ptr<vfs::file>> shown;
+        for (const auto& file : this->dir->files())
+        {
+            if (this->find_row(file.get()) == -1 &&
+                (this->show_hidden || !file->is_hidden()) && this->is_pattern_match(file->name()))
+            {
+                shown.push_back(file);
+            }
+        }
+        this->insert_files(shown);
+        this->load_thumbnails(shown);
+    }
+}
+
+i32
+ptk::file_list::find_row(const vfs::file* file) const noexcept
+{
+    const auto it = this->rows.find(file);
+    if (it == this->rows.cend())
+    {
+        return -1;
+    }
+    return static_cast<i32>(it->second);
+}
+
+void
+ptk::file_list::set_iter(GtkTreeIter* iter, const usize row) const noexcept
+{
+    assert(row < this->size());
+
+    if (this->virtual_dir)
+    { // a pointer to the entry, the row is a hint like for files
+        iter->stamp = this->stamp;
+        iter->user_data = (void*)&this->dir->entries()[this->entry_rows[row]];
+        iter->user_data2 = nullptr;
+        iter->user_data3 = GUINT_TO_POINTER(row);
+        return;
+    }
+
+    /* We simply store a pointer to the file in the iter, plus the row it was at as a hint */
+    iter->stamp = this->stamp;
+    iter->user_data = this->files[row].get();
+    iter->user_data2 = this->files[row].get();
+    iter->user_data3 = GUINT_TO_POINTER(row);
+}
+
+usize
+ptk::file_list::size() const noexcept
+{
+    return this->virtual_dir ? this->entry_rows.size() : this->files.size();
+}
+
+void
+ptk::file_list::update_entry_positions() noexcept
+{
+    this->entry_positions.assign(this->dir->entries().size(), hidden_entry_row);
+    for (usize row = 0; row < this->entry_rows.size(); ++row)
+    {
+        this->entry_positions[this->entry_rows[row]] = static_cast<u32>(row);
+    }
+}
+
+void
+ptk::file_list::update_rows(const usize from) noexcept
+{
+    if (from == 0)
+    {
+        this->rows.clear();
+        this->rows.reserve(this->files.size());
+    }
+    for (usize index = from; index < this->files.size(); ++index)
+    {
+        this->rows.insert_or_assign(this->files[index].get(), static_cast<u32>(index));
+    }
+}
+
+static i32
+ptk_file_list_iter_row(ptk::file_list* list, GtkTreeIter* iter) noexcept
 {
-    if (!this->pattern || std::strlen(this->pattern) == 0)
+    // the hint is only stale if the model changed since the iter was made
+    const auto hint = GPOINTER_TO_UINT(iter->user_data3);
+    if (list->virtual_dir)
     {
-        return true;
+        const auto entries = list->dir->entries();
+        const auto* const entry = static_cast<const vfs::linux::dirent::entry*>(iter->user_data);
+        if (entry < entries.data() || entry >= entries.data() + entries.size())
+        {
+            return -1;
+        }
+        const auto index = static_cast<usize>(entry - entries.data());
+        if (hint < list->entry_rows.size() && list->entry_rows[hint] == index)
+        {
+            return static_cast<i32>(hint);
+        }
+        const auto row = list->entry_positions[index];
+        return row == ptk::file_list::hidden_entry_row ? -1 : static_cast<i32>(row);
     }
-    return fnmatch(this->pattern, filename.c_str(), 0) == 0;
+    if (hint < list->files.size() && list->files[hint].get() == iter->user_data)
+    {
+        return static_cast<i32>(hint);
+    }
+    return list->find_row(static_cast<vfs::file*>(iter->user_data));
 }
 
 static GtkTreeModelFlags
@@ -299,19 +452,12 @@ ptk_file_list_get_iter(GtkTreeModel* tree_model, GtkTreeIter* iter, GtkTreePath*
 
     const u32 n = indices[0]; /* the n-th top level row */
 
-    if (n >= g_list_length(list->files) /* || n < 0 */)
+    if (n >= list->size() /* || n < 0 */)
     {
         return false;
     }
 
-    GList* l = g_list_nth(list->files, n);
-    assert(l != nullptr);
-
-    /* We simply store a pointer in the iter */
-    iter->stamp = list->stamp;
-    iter->user_data = l;
-    iter->user_data2 = l->data;
-    iter->user_data3 = nullptr; /* unused */
+    list->set_iter(iter, n);
 
     return true;
 }
@@ -325,11 +471,13 @@ ptk_file_list_get_path(GtkTreeModel* tree_model, GtkTreeIter* iter) noexcept
     assert(iter != nullptr);
     // assert(iter->stamp != list->stamp);
     assert(iter->user_data != nullptr);
-    GList* l = (GList*)iter->user_data;
 
-    GtkTreePath* path = gtk_tree_path_new();
-    gtk_tree_path_append_index(path, g_list_index(list->files, l->data));
-    return path;
+    const auto row = ptk_file_list_iter_row(list, iter);
+    if (row == -1)
+    {
+        return nullptr;
+    }
+    return gtk_tree_path_new_from_indices(row, -1);
 }
 
 static void
@@ -345,7 +493,26 @@ ptk_file_list_get_value(GtkTreeModel* tree_model, GtkTreeIter* iter, i32 column,
 
     g_value_init(value, global::column_types.at(ptk::file_list::column(column)));
 
-    const auto file = static_cast<vfs::file*>(iter->user_data2)->shared_from_this();
+    std::shared_ptr<vfs::file> file;
+    if (list->virtual_dir)
+    {
+        const auto* const entry = static_cast<const vfs::linux::dirent::entry*>(iter->user_data);
+        if (ptk::file_list::column(column) == ptk::file_list::column::name)
+        { // drawing the name never needs a vfs::file
+            g_value_set_string(value, entry->name.data());
+            return;
+        }
+
+        file = list->dir->materialize(entry->name);
+        if (!file)
+        { // deleted since the directory was read
+            return;
+        }
+    }
+    else
+    {
+        file = static_cast<vfs::file*>(iter->user_data2)->shared_from_this();
+    }
 
     GdkPixbuf* icon = nullptr;
 
@@ -441,17 +608,15 @@ ptk_file_list_iter_next(GtkTreeModel* tree_model, GtkTreeIter* iter) noexcept
     ptk::file_list* list = PTK_FILE_LIST_REINTERPRET(tree_model);
     assert(list != nullptr);
 
-    GList* l = (GList*)iter->user_data;
+    const auto row = ptk_file_list_iter_row(list, iter);
 
-    /* Is this the last l in the list? */
-    if (!l->next)
+    /* Is this the last row in the list? */
+    if (row == -1 || static_cast<usize>(row) + 1 >= list->size())
     {
         return false;
     }
 
-    iter->stamp = list->stamp;
-    iter->user_data = l->next;
-    iter->user_data2 = l->next->data;
+    list->set_iter(iter, row + 1);
 
     return true;
 }
@@ -467,23 +632,18 @@ ptk_file_list_iter_children(GtkTreeModel* tree_model, GtkTreeIter* iter,
     }
 
     /* parent == nullptr is a special case; we need to return the first top-level row */
-    assert(parent != nullptr);
-    assert(parent->user_data != nullptr);
-
     assert(PTK_IS_FILE_LIST(tree_model) == true);
     ptk::file_list* list = PTK_FILE_LIST_REINTERPRET(tree_model);
     assert(list != nullptr);
 
     /* No rows => no first row */
-    if (list->dir->files().empty())
+    if (list->size() == 0)
     {
         return false;
     }
 
     /* Set iter to first item in list */
-    iter->stamp = list->stamp;
-    iter->user_data = list->files;
-    iter->user_data2 = list->files->data;
+    list->set_iter(iter, 0);
     return true;
 }
 
@@ -505,7 +665,7 @@ ptk_file_list_iter_n_children(GtkTreeModel* tree_model, GtkTreeIter* iter) noexc
     /* special case: if iter == nullptr, return number of top-level rows */
     if (!iter)
     {
-        return g_list_length(list->files);
+        return static_cast<i32>(list->size());
     }
     return 0; /* otherwise, this is easy again for a list */
 }
@@ -526,17 +686,12 @@ ptk_file_list_iter_nth_child(GtkTreeModel* tree_model, GtkTreeIter* iter, GtkTre
     }
 
     /* special case: if parent == nullptr, set iter to n-th top-level row */
-    if (static_cast<u32>(n) >= g_list_length(list->files))
-    { //  || n < 0)
+    if (n < 0 || static_cast<usize>(n) >= list->size())
+    {
         return false;
     }
 
-    GList* l = g_list_nth(list->files, n);
-    assert(l != nullptr);
-
-    iter->stamp = list->stamp;
-    iter->user_data = l;
-    iter->user_data2 = l->data;
+    list->set_iter(iter, n);
 
     return true;
 }
@@ -605,249 +760,482 @@ ptk_file_list_set_default_sort_func(GtkTreeSortable* sortable, GtkTreeIterCompar
     ztd::logger::warn("ptk_file_list_set_default_sort_func: Not supported");
 }
 
-static i32
-compare_file_name(const std::shared_ptr<vfs::file>& a, const std::shared_ptr<vfs::file>& b,
-                  ptk::file_list* list) noexcept
-{
-    i32 result = 0;
-    // by display name
-    if (list->sort_natural)
-    {
-        // natural
-        if (list->sort_case)
-        {
-            result = strnatcmp(a->name(), b->name());
-        }
-        else
-        {
-            result = strnatcasecmp(a->name(), b->name());
-        }
-    }
-    else
-    {
-        // non-natural
-        result = a->name().compare(b->name());
-    }
-    return result;
-}
+// ptk::file_list
 
-static i32
-compare_file_size(const std::shared_ptr<vfs::file>& a, const std::shared_ptr<vfs::file>& b,
-                  ptk::file_list* list) noexcept
+ptk::file_list::sort_options
+ptk::file_list::current_sort_options() const noexcept
 {
-    (void)list;
-    return (a->size() > b->size()) ? 1 : ((a->size() == b->size()) ? 0 : -1);
+    return {this->sort_col,
+            this->sort_order,
+            this->sort_dir_,
+            this->sort_natural,
+            this->sort_case,
+            this->sort_hidden_first,
+            this->sort_then};
 }
 
-static i32
-compare_file_type(const std::shared_ptr<vfs::file>& a, const std::shared_ptr<vfs::file>& b,
-                  ptk::file_list* list) noexcept
+void
+ptk::file_list::update_sort_options() noexcept
 {
-    (void)list;
-    return a->mime_type()->description().compare(b->mime_type()->description());
-}
+    assert(this->sort_col != ptk::file_list::column::big_icon);
+    assert(this->sort_col != ptk::file_list::column::small_icon);
+    assert(this->sort_col != ptk::file_list::column::info);
 
-static i32
-compare_file_mime(const std::shared_ptr<vfs::file>& a, const std::shared_ptr<vfs::file>& b,
-                  ptk::file_list* list) noexcept
-{
-    (void)list;
-    return a->mime_type()->description().compare(b->mime_type()->description());
+    this->sort_keys.set_options(this->current_sort_options());
 }
 
-static i32
-compare_file_perm(const std::shared_ptr<vfs::file>& a, const std::shared_ptr<vfs::file>& b,
-                  ptk::file_list* list) noexcept
+bool
+ptk::file_list::sort_less(const std::shared_ptr<vfs::file>& a,
+                          const std::shared_ptr<vfs::file>& b) noexcept
 {
-    (void)list;
-    return a->display_permissions().compare(b->display_permissions());
+    return compare_sort_keys(this->sort_keys.get(a),
+                             this->sort_keys.get(b),
+                             this->sort_keys.options()) < 0;
 }
 
-static i32
-compare_file_owner(const std::shared_ptr<vfs::file>& a, const std::shared_ptr<vfs::file>& b,
-                   ptk::file_list* list) noexcept
+void
+ptk::file_list::set_dir(const std::shared_ptr<vfs::dir>& new_dir) noexcept
 {
-    (void)list;
-    return a->display_owner().compare(b->display_owner());
-}
+    if (this->dir == new_dir)
+    {
+        return;
+    }
 
-static i32
-compare_file_group(const std::shared_ptr<vfs::file>& a, const std::shared_ptr<vfs::file>& b,
-                   ptk::file_list* list) noexcept
-{
-    (void)list;
-    return a->display_group().compare(b->display_group());
-}
+    if (this->dir)
+    {
+        this->signal_file_changes.disconnect();
+        this->signal_file_deleted.disconnect();
+        this->signal_file_thumbnail_loaded.disconnect();
+    }
 
-static i32
-compare_file_atime(const std::shared_ptr<vfs::file>& a, const std::shared_ptr<vfs::file>& b,
-                   ptk::file_list* list) noexcept
-{
-    (void)list;
-    return (a->atime() > b->atime()) ? 1 : ((a->atime() == b->atime()) ? 0 : -1);
+    this->dir = new_dir;
+    this->files.clear();
+    this->rows.clear();
+    this->sort_keys.clear();
+    this->entry_rows.clear();
+    this->entry_positions.clear();
+    this->virtual_dir = false;
+    if (!new_dir)
+    {
+        return;
+    }
+
+    if (new_dir->is_virtual())
+    {
+        this->virtual_dir = true;
+
+        const auto entries = new_dir->entries();
+        this->entry_rows.reserve(entries.size());
+        for (usize index = 0; index < entries.size(); ++index)
+        {
+            const std::string_view name = entries[index].name;
+            if ((this->show_hidden || !name.starts_with('.')) && this->is_pattern_match(name))
+            {
+                this->entry_rows.push_back(static_cast<u32>(index));
+            }
+        }
+        this->update_entry_positions();
+        return;
+    }
+
+    this->signal_file_changes = this->dir->add_event<spacefm::signal::file_changes>(
+        std::bind(&ptk::file_list::on_file_list_file_changes, this, std::placeholders::_1));
+    this->signal_file_deleted = this->dir->add_event<spacefm::signal::file_deleted>(
+        std::bind(&ptk::file_list::on_file_list_file_deleted, this, std::placeholders::_1));
+
+    const auto& dir_files = new_dir->files();
+    this->files.reserve(dir_files.size());
+    for (const auto& file : dir_files)
+    {
+        if ((this->show_hidden || !file->is_hidden()) && this->is_pattern_match(file->name()))
+        {
+            this->files.push_back(file);
+        }
+    }
+    this->update_rows();
 }
 
-static i32
-compare_file_btime(const std::shared_ptr<vfs::file>& a, const std::shared_ptr<vfs::file>& b,
-                   ptk::file_list* list) noexcept
+void
+ptk::file_list::sort() noexcept
 {
-    (void)list;
-    return (a->btime() > b->btime()) ? 1 : ((a->btime() == b->btime()) ? 0 : -1);
+    if (this->size() <= 1)
+    {
+        return;
+    }
+
+    if (this->virtual_dir)
+    {
+        this->update_sort_options();
+        sort_entry_rows(this->entry_rows,
+                        this->dir->entries(),
+                        this->dir->path(),
+                        this->sort_keys.options());
+
+        // new_order[new row] = old row, entry_positions still holds the old positions
+        std::vector<i32> new_order;
+        new_order.reserve(this->entry_rows.size());
+        for (const auto index : this->entry_rows)
+        {
+            new_order.push_back(static_cast<i32>(this->entry_positions[index]));
+        }
+        this->update_entry_positions();
+
+        GtkTreePath* path = gtk_tree_path_new();
+        gtk_tree_model_rows_reordered(GTK_TREE_MODEL(this), path, nullptr, new_order.data());
+        gtk_tree_path_free(path);
+        return;
+    }
+
+    /* sort the list */
+    this->update_sort_options();
+    sort_files(this->files, this->sort_keys);
+
+    // new_order[new row] = old row, rows still holds the old positions
+    std::vector<i32> new_order;
+    new_order.reserve(this->files.size());
+    for (const auto& file : this->files)
+    {
+        new_order.push_back(static_cast<i32>(this->rows.at(file.get())));
+    }
+    this->update_rows();
+
+    GtkTreePath* path = gtk_tree_path_new();
+    gtk_tree_model_rows_reordered(GTK_TREE_MODEL(this), path, nullptr, new_order.data());
+    gtk_tree_path_free(path);
 }
 
-static i32
-compare_file_ctime(const std::shared_ptr<vfs::file>& a, const std::shared_ptr<vfs::file>& b,
-                   ptk::file_list* list) noexcept
+void
+ptk::file_list::add_files(const std::span<const std::shared_ptr<vfs::file>> new_files) noexcept
 {
-    (void)list;
-    return (a->ctime() > b->ctime()) ? 1 : ((a->ctime() == b->ctime()) ? 0 : -1);
+    std::vector<std::shared_ptr<vfs::file>> added;
+    added.reserve(new_files.size());
+    for (const auto& file : new_files)
+    {
+        if ((this->show_hidden || !file->is_hidden()) && this->is_pattern_match(file->name()))
+        {
+            added.push_back(file);
+        }
+    }
+
+    if (added.empty())
+    {
+        return;
+    }
+
+    this->update_sort_options();
+    std::ranges::sort(added,
+                      [this](const auto& a, const auto& b) { return this->sort_less(a, b); });
+
+    this->merge_files(added);
+    this->load_thumbnails(added);
 }
 
-static i32
-compare_file_mtime(const std::shared_ptr<vfs::file>& a, const std::shared_ptr<vfs::file>& b,
-                   ptk::file_list* list) noexcept
+void
+ptk::file_list::load_thumbnails(const std::span<const std::shared_ptr<vfs::file>> added) noexcept
 {
-    (void)list;
-    return (a->mtime() > b->mtime()) ? 1 : ((a->mtime() == b->mtime()) ? 0 : -1);
-}
+    if (this->max_thumbnail == 0)
+    {
+        return;
+    }
 
-using compare_function_t = std::function<i32(const std::shared_ptr<vfs::file>&,
-                                             const std::shared_ptr<vfs::file>&, ptk::file_list*)>;
+    for (const auto& file : added)
+    {
+        if ((file->mime_type()->is_video() ||
+             (file->size() < this->max_thumbnail && file->mime_type()->is_image())) &&
+            !file->is_thumbnail_loaded(this->thumbnail_size))
+        {
+            this->dir->load_thumbnail(file, this->thumbnail_size);
+        }
+    }
+}
 
-static i32
-compare_file(const std::shared_ptr<vfs::file>& a, const std::shared_ptr<vfs::file>& b,
-             ptk::file_list* list, const compare_function_t& func) noexcept
+void
+ptk::file_list::merge_files(const std::span<const std::shared_ptr<vfs::file>> added) noexcept
 {
-    // dirs before/after files
-    if (list->sort_dir_ != ptk::file_list::sort_dir::mixed)
+    // merge the sorted batch into the already sorted list, remembering
+    // which rows are new so row-inserted can be emitted for them.
+    const auto current = std::move(this->files);
+
+    std::vector<std::shared_ptr<vfs::file>> merged;
+    std::vector<bool> is_new;
+    merged.reserve(current.size() + added.size());
+    is_new.reserve(current.size() + added.size());
+
+    auto cur_it = current.cbegin();
+    auto add_it = added.cbegin();
+    while (cur_it != current.cend() || add_it != added.cend())
     {
-        const auto result = a->is_directory() - b->is_directory();
-        if (result != 0)
+        if (add_it != added.cend() &&
+            (cur_it == current.cend() || this->sort_less(*add_it, *cur_it)))
         {
-            return list->sort_dir_ == ptk::file_list::sort_dir::first ? -result : result;
+            merged.push_back(*add_it++);
+            is_new.push_back(true);
+        }
+        else
+        {
+            merged.push_back(*cur_it++);
+            is_new.push_back(false);
         }
     }
 
-    const auto result = func(a, b, list);
+    this->files = std::move(merged);
+    this->update_rows();
+
+    // rows are announced in ascending order, so every row before
+    // the inserted one is already known to the view.
+    for (usize index = 0; index < this->files.size(); ++index)
+    {
+        if (!is_new[index])
+        {
+            continue;
+        }
+
+        GtkTreeIter it;
+        this->set_iter(&it, index);
 
-    return list->sort_order == GtkSortType::GTK_SORT_ASCENDING ? result : -result;
+        GtkTreePath* path = gtk_tree_path_new_from_indices(static_cast<i32>(index), -1);
+        gtk_tree_model_row_inserted(GTK_TREE_MODEL(this), path, &it);
+        gtk_tree_path_free(path);
+    }
 }
 
-static GList*
-ptk_file_info_list_sort(ptk::file_list* list) noexcept
+void
+ptk::file_list::insert_file(const std::shared_ptr<vfs::file>& file) noexcept
 {
-    assert(list->sort_col != ptk::file_list::column::big_icon);
-    assert(list->sort_col != ptk::file_list::column::small_icon);
-    assert(list->sort_col != ptk::file_list::column::info);
+    // after any equal rows, the same place a stable sort would put it
+    const auto position =
+        std::ranges::upper_bound(this->files,
+                                 file,
+                                 [this](const auto& a, const auto& b)
+                                 { return this->sort_less(a, b); });
+    const auto row = std::distance(this->files.begin(), position);
 
-    static const ztd::map<ptk::file_list::column, compare_function_t, 12>
-        compare_function_ptr_table{{{
-            {ptk::file_list::column::name, &compare_file_name},
-            {ptk::file_list::column::size, &compare_file_size},
-            {ptk::file_list::column::bytes, &compare_file_size},
-            {ptk::file_list::column::type, &compare_file_type},
-            {ptk::file_list::column::mime, &compare_file_mime},
-            {ptk::file_list::column::perm, &compare_file_perm},
-            {ptk::file_list::column::owner, &compare_file_owner},
-            {ptk::file_list::column::group, &compare_file_group},
-            {ptk::file_list::column::atime, &compare_file_atime},
-            {ptk::file_list::column::btime, &compare_file_btime},
-            {ptk::file_list::column::ctime, &compare_file_ctime},
-            {ptk::file_list::column::mtime, &compare_file_mtime},
-        }}};
+    this->files.insert(position, file);
+    this->update_rows(row);
 
-    auto file_list = glist_to_vector_vfs_file(list->files);
-
-    std::ranges::sort(
-        file_list.begin(),
-        file_list.end(),
-        [&list](const auto& a, const auto& b)
-        { return compare_file(a, b, list, compare_function_ptr_table.at(list->sort_col)) < 0; });
+    GtkTreeIter it;
+    this->set_iter(&it, row);
 
-    return vector_to_glist_vfs_file(file_list);
+    GtkTreePath* path = gtk_tree_path_new_from_indices(static_cast<i32>(row), -1);
+    gtk_tree_model_row_inserted(GTK_TREE_MODEL(this), path, &it);
+    gtk_tree_path_free(path);
 }
 
-// ptk::file_list
-
 void
-ptk::file_list::set_dir(const std::shared_ptr<vfs::dir>& new_dir) noexcept
+ptk::file_list::insert_files(const std::span<const std::shared_ptr<vfs::file>> created) noexcept
 {
-    if (this->dir == new_dir)
+    std::vector<std::shared_ptr<vfs::file>> added;
+    added.reserve(created.size());
+    for (const auto& file : created)
+    {
+        if ((this->show_hidden || !file->is_hidden()) && this->is_pattern_match(file->name()) &&
+            this->find_row(file.get()) == -1)
+        {
+            added.push_back(file);
+        }
+    }
+
+    if (added.empty())
     {
         return;
     }
 
-    if (this->dir)
+    this->update_sort_options();
+
+    if (added.size() < INSERT_MERGE_THRESHOLD)
     {
-        g_list_free(this->files);
+        for (const auto& file : added)
+        {
+            this->insert_file(file);
+        }
+        return;
+    }
 
-        this->signal_file_created.disconnect();
-        this->signal_file_deleted.disconnect();
-        this->signal_file_changed.disconnect();
-        this->signal_file_thumbnail_loaded.disconnect();
+    std::ranges::sort(added,
+                      [this](const auto& a, const auto& b) { return this->sort_less(a, b); });
+    this->merge_files(added);
+}
+
+void
+ptk::file_list::remove_files(const std::span<const std::shared_ptr<vfs::file>> deleted) noexcept
+{
+    std::vector<i32> removed;
+    removed.reserve(deleted.size());
+    for (const auto& file : deleted)
+    {
+        const auto row = this->find_row(file.get());
+        if (row != -1)
+        {
+            removed.push_back(row);
+            this->rows.erase(file.get());
+            this->sort_keys.erase(file.get());
+        }
     }
 
-    this->dir = new_dir;
-    this->files = nullptr;
-    if (!new_dir)
+    if (removed.empty())
     {
         return;
     }
 
-    this->signal_file_created = this->dir->add_event<spacefm::signal::file_created>(
-        std::bind(&ptk::file_list::on_file_list_file_created, this, std::placeholders::_1));
-    this->signal_file_deleted = this->dir->add_event<spacefm::signal::file_deleted>(
-        std::bind(&ptk::file_list::on_file_list_file_deleted, this, std::placeholders::_1));
-    this->signal_file_changed = this->dir->add_event<spacefm::signal::file_changed>(
-        std::bind(&ptk::file_list::on_file_list_file_changed, this, std::placeholders::_1));
+    std::ranges::sort(removed);
 
-    for (const auto& file : new_dir->files())
+    // compact the list in one pass, the rows must be gone
+    // from the model before row-deleted is emitted.
+    usize next_removed = 0;
+    usize kept = 0;
+    for (usize index = 0; index < this->files.size(); ++index)
     {
-        if ((this->show_hidden || !file->is_hidden()) && this->is_pattern_match(file->name()))
+        if (next_removed < removed.size() &&
+            static_cast<usize>(removed[next_removed]) == index)
         {
-            this->files = g_list_prepend(this->files, file.get());
+            ++next_removed;
+            continue;
         }
+        if (kept != index)
+        {
+            this->files[kept] = std::move(this->files[index]);
+        }
+        ++kept;
+    }
+    this->files.resize(kept);
+    this->update_rows(removed.front());
+
+    // rows are announced in descending order, so no announced
+    // row changes the index of one that is still to come.
+    for (const auto row : std::views::reverse(removed))
+    {
+        GtkTreePath* path = gtk_tree_path_new_from_indices(row, -1);
+        gtk_tree_model_row_deleted(GTK_TREE_MODEL(this), path);
+        gtk_tree_path_free(path);
     }
 }
 
 void
-ptk::file_list::sort() noexcept
+ptk::file_list::update_files(const std::span<const std::shared_ptr<vfs::file>> changed) noexcept
 {
-    if (g_list_length(this->files) <= 1)
+    // the cached keys are for the old file info, drop them even while loading
+    // so that files inserted or sorted later are not placed by stale data
+    for (const auto& file : changed)
+    {
+        this->sort_keys.erase(file.get());
+    }
+
+    if (this->dir->is_loading())
     {
         return;
     }
 
-    /* sort the list */
-    this->files = ptk_file_info_list_sort(this);
+    this->update_sort_options();
 
-    GtkTreePath* path = gtk_tree_path_new();
-    gtk_tree_model_rows_reordered(GTK_TREE_MODEL(this), path, nullptr, nullptr);
-    gtk_tree_path_free(path);
+    bool resort = false;
+    for (const auto& file : changed)
+    {
+        const auto row = this->find_row(file.get());
+        if (row == -1)
+        {
+            continue;
+        }
+
+        GtkTreeIter it;
+        this->set_iter(&it, row);
+
+        GtkTreePath* path = gtk_tree_path_new_from_indices(row, -1);
+        gtk_tree_model_row_changed(GTK_TREE_MODEL(this), path, &it);
+        gtk_tree_path_free(path);
+
+        // the change may have moved the file relative to its neighbours, i.e. size or mtime
+        const auto index = static_cast<usize>(row);
+        if ((index > 0 && this->sort_less(this->files[index], this->files[index - 1])) ||
+            (index + 1 < this->files.size() &&
+             this->sort_less(this->files[index + 1], this->files[index])))
+        {
+            resort = true;
+        }
+    }
+
+    if (resort)
+    {
+        this->sort();
+    }
 }
 
 void
-ptk::file_list::file_created(const std::shared_ptr<vfs::file>& file) noexcept
+ptk::file_list::rename_files(
+    const std::span<const vfs::dir::change_set::renamed_file> renamed) noexcept
 {
-    if ((!this->show_hidden && file->is_hidden()) || !this->is_pattern_match(file->name()))
+    if (renamed.empty())
     {
         return;
     }
 
-    this->files = g_list_append(this->files, file.get());
+    this->update_sort_options();
+
+    // a renamed file keeps its row, and its thumbnail, unless the new name
+    // is filtered out or is no longer in order with its neighbours
+    std::vector<std::shared_ptr<vfs::file>> hidden;
+    std::vector<std::shared_ptr<vfs::file>> shown;
+    std::vector<std::shared_ptr<vfs::file>> kept;
+    for (const auto& [old_file, file] : renamed)
+    {
+        // the cached key is for the old name
+        this->sort_keys.erase(old_file.get());
+
+        // the new vfs::file takes over the row of the old one
+        const auto row = this->find_row(old_file.get());
+        const bool listed = row != -1;
+        if (listed)
+        {
+            this->files[static_cast<usize>(row)] = file;
+            this->rows.erase(old_file.get());
+            this->rows.insert_or_assign(file.get(), static_cast<u32>(row));
+        }
+
+        const bool visible =
+            (this->show_hidden || !file->is_hidden()) && this->is_pattern_match(file->name());
+        if (listed && !visible)
+        {
+            hidden.push_back(file);
+        }
+        else if (!listed && visible)
+        {
+            shown.push_back(file);
+        }
+        else if (listed)
+        {
+            kept.push_back(file);
+        }
+    }
+
+    this->remove_files(hidden);
 
-    this->sort();
+    bool resort = false;
+    for (const auto& file : kept)
+    {
+        const auto row = this->find_row(file.get());
 
-    GList* l = g_list_find(this->files, file.get());
+        GtkTreeIter it;
+        this->set_iter(&it, row);
 
-    GtkTreeIter it;
-    it.stamp = this->stamp;
-    it.user_data = l;
-    it.user_data2 = file.get();
+        GtkTreePath* path = gtk_tree_path_new_from_indices(row, -1);
+        gtk_tree_model_row_changed(GTK_TREE_MODEL(this), path, &it);
+        gtk_tree_path_free(path);
 
-    GtkTreePath* path = gtk_tree_path_new_from_indices(g_list_index(this->files, l->data), -1);
-    gtk_tree_model_row_inserted(GTK_TREE_MODEL(this), path, &it);
-    gtk_tree_path_free(path);
+        const auto index = static_cast<usize>(row);
+        if ((index > 0 && this->sort_less(this->files[index], this->files[index - 1])) ||
+            (index + 1 < this->files.size() &&
+             this->sort_less(this->files[index + 1], this->files[index])))
+        {
+            resort = true;
+        }
+    }
+
+    // one reorder for the whole batch, rows keep their selection
+    if (resort)
+    {
+        this->sort();
+    }
+
+    this->insert_files(shown);
 }
 
 void
@@ -863,61 +1251,77 @@ ptk::file_list::file_changed(const std::shared_ptr<vfs::file>& file) noexcept
         return;
     }
 
-    GList* l = g_list_find(this->files, file.get());
-    if (!l)
+    const auto row = this->find_row(file.get());
+    if (row == -1)
     {
         return;
     }
 
     GtkTreeIter it;
-    it.stamp = this->stamp;
-    it.user_data = l;
-    it.user_data2 = l->data;
+    this->set_iter(&it, row);
 
-    GtkTreePath* path = gtk_tree_path_new_from_indices(g_list_index(this->files, l->data), -1);
+    GtkTreePath* path = gtk_tree_path_new_from_indices(row, -1);
     gtk_tree_model_row_changed(GTK_TREE_MODEL(this), path, &it);
     gtk_tree_path_free(path);
 }
 
 void
-ptk::file_list::on_file_list_file_changed(const std::shared_ptr<vfs::file>& file) noexcept
+ptk::file_list::on_file_list_file_changes(const vfs::dir::change_set& changes) noexcept
 {
-    if (!file || !this->dir)
+    if (!this->dir)
     {
         return;
     }
 
-    this->file_changed(file);
+    // apply the whole batch before touching thumbnails, deleted first
+    // so that nothing is inserted relative to a row that is going away.
+    this->remove_files(changes.deleted);
+    this->rename_files(changes.renamed);
+    this->update_files(changes.changed);
+    this->insert_files(changes.created);
+
+    if (this->max_thumbnail == 0)
+    {
+        return;
+    }
 
     // check if reloading of thumbnail is needed.
     // See also desktop-window.c:on_file_changed()
     const auto now = std::chrono::system_clock::now();
 
-    if (this->max_thumbnail != 0 &&
-        ((file->mime_type()->is_video() && (now - file->mtime() > std::chrono::seconds(5))) ||
-         (file->size() < this->max_thumbnail && file->mime_type()->is_image())))
+    for (const auto& file : changes.changed)
     {
-        if (!file->is_thumbnail_loaded(this->thumbnail_size))
+        if ((file->mime_type()->is_video() && (now - file->mtime() > std::chrono::seconds(5))) ||
+            (file->size() < this->max_thumbnail && file->mime_type()->is_image()))
         {
-            this->dir->load_thumbnail(file, this->thumbnail_size);
+            if (!file->is_thumbnail_loaded(this->thumbnail_size))
+            {
+                this->dir->load_thumbnail(file, this->thumbnail_size);
+            }
         }
     }
-}
-
-void
-ptk::file_list::on_file_list_file_created(const std::shared_ptr<vfs::file>& file) noexcept
-{
-    this->file_created(file);
 
-    /* check if reloading of thumbnail is needed. */
-    if (this->max_thumbnail != 0 &&
-        (file->mime_type()->is_video() ||
-         (file->size() < this->max_thumbnail && file->mime_type()->is_image())))
+    const auto load_new_thumbnail = [this](const std::shared_ptr<vfs::file>& file)
     {
-        if (!file->is_thumbnail_loaded(this->thumbnail_size))
+        if (file->mime_type()->is_video() ||
+            (file->size() < this->max_thumbnail && file->mime_type()->is_image()))
         {
-            this->dir->load_thumbnail(file, this->thumbnail_size);
+            if (!file->is_thumbnail_loaded(this->thumbnail_size))
+            {
+                this->dir->load_thumbnail(file, this->thumbnail_size);
+            }
         }
+    };
+
+    for (const auto& file : changes.created)
+    {
+        load_new_thumbnail(file);
+    }
+
+    // a renamed file only keeps its thumbnails if its type did not change
+    for (const auto& renamed : changes.renamed)
+    {
+        load_new_thumbnail(renamed.file);
     }
 }
 
@@ -927,32 +1331,22 @@ ptk::file_list::on_file_list_file_deleted(const std::shared_ptr<vfs::file>& file
     /* If there is no file info, that means the dir itself was deleted. */
     if (!file)
     {
-        /* Clear the whole list */
-        GtkTreePath* path = gtk_tree_path_new_from_indices(0, -1);
-        for (GList* l = this->files; l; l = this->files)
+        /* Clear the whole list, from the end so no row has to be shifted */
+        this->rows.clear();
+        this->sort_keys.clear();
+        while (!this->files.empty())
         {
+            this->files.pop_back();
+
+            const auto index = static_cast<i32>(this->files.size());
+            GtkTreePath* path = gtk_tree_path_new_from_indices(index, -1);
             gtk_tree_model_row_deleted(GTK_TREE_MODEL(this), path);
+            gtk_tree_path_free(path);
         }
-        gtk_tree_path_free(path);
-        return;
-    }
-
-    if ((!this->show_hidden && file->is_hidden()) || !this->is_pattern_match(file->name()))
-    {
-        return;
-    }
-
-    GList* l = g_list_find(this->files, file.get());
-    if (!l)
-    {
         return;
     }
 
-    GtkTreePath* path = gtk_tree_path_new_from_indices(g_list_index(this->files, l->data), -1);
-    gtk_tree_model_row_deleted(GTK_TREE_MODEL(this), path);
-    gtk_tree_path_free(path);
-
-    this->files = g_list_delete_link(this->files, l);
+    this->remove_files(std::span(&file, 1));
 }
 
 void
@@ -965,6 +1359,12 @@ ptk::file_list::on_file_list_file_thumbnail_loaded(const std::shared_ptr<vfs::fi
 void
 ptk::file_list::show_thumbnails(const vfs::file::thumbnail_size size, u64 max_file_size) noexcept
 {
+    if (this->max_thumbnail == max_file_size && this->thumbnail_size == size &&
+        (max_file_size == 0 || this->signal_file_thumbnail_loaded.connected()))
+    { // unchanged, i.e. a list taken from ptk::file_list_cache
+        return;
+    }
+
     const u64 old_max_thumbnail = this->max_thumbnail;
     this->max_thumbnail = max_file_size;
     this->thumbnail_size = size;
@@ -977,9 +1377,8 @@ ptk::file_list::show_thumbnails(const vfs::file::thumbnail_size size, u64 max_fi
 
             this->signal_file_thumbnail_loaded.disconnect();
 
-            for (GList* l = this->files; l; l = g_list_next(l))
+            for (const auto& file : this->files)
             {
-                const auto file = static_cast<vfs::file*>(l->data)->shared_from_this();
                 if ((file->mime_type()->is_image() || file->mime_type()->is_video()) &&
                     file->is_thumbnail_loaded(this->thumbnail_size))
                 {
@@ -995,15 +1394,16 @@ ptk::file_list::show_thumbnails(const vfs::file::thumbnail_size size, u64 max_fi
         return;
     }
 
+    // already connected if only the size changed
+    this->signal_file_thumbnail_loaded.disconnect();
     this->signal_file_thumbnail_loaded =
         this->dir->add_event<spacefm::signal::file_thumbnail_loaded>(
             std::bind(&ptk::file_list::on_file_list_file_thumbnail_loaded,
                       this,
                       std::placeholders::_1));
 
-    for (GList* l = this->files; l; l = g_list_next(l))
+    for (const auto& file : this->files)
     {
-        const auto file = static_cast<vfs::file*>(l->data)->shared_from_this();
         if (this->max_thumbnail != 0 &&
             (file->mime_type()->is_video() ||
              (file->size() < this->max_thumbnail && file->mime_type()->is_image())))
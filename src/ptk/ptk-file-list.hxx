@@ -17,10 +17,23 @@
 
 #pragma once
 
+#include <string>
 #include <string_view>
 
+#include <filesystem>
+
+#include <span>
+
+#include <vector>
+
+#include <unordered_map>
+
+#include <optional>
+
 #include <memory>
 
+#include <limits>
+
 #include <gtkmm.h>
 #include <glibmm.h>
 #include <sigc++/sigc++.h>
@@ -30,6 +43,10 @@
 #include "vfs/vfs-dir.hxx"
 #include "vfs/vfs-file.hxx"
 
+#include "vfs/linux/dirent.hxx"
+
+#include "ptk/ptk-file-filter.hxx"
+
 #define PTK_FILE_LIST(obj)             (static_cast<ptk::file_list*>(obj))
 #define PTK_FILE_LIST_REINTERPRET(obj) (reinterpret_cast<ptk::file_list*>(obj))
 
@@ -63,6 +80,89 @@ struct file_list
         last
     };
 
+    // a column files are sorted by when they are equal in every column before it
+    struct sort_column
+    {
+        ptk::file_list::column column{ptk::file_list::column::name};
+        GtkSortType order{GtkSortType::GTK_SORT_ASCENDING};
+
+        bool operator==(const sort_column& other) const noexcept = default;
+    };
+
+    struct sort_options
+    {
+        ptk::file_list::column column{ptk::file_list::column::name};
+        GtkSortType order{GtkSortType::GTK_SORT_ASCENDING};
+        ptk::file_list::sort_dir dir{ptk::file_list::sort_dir::mixed};
+        bool natural{false};
+        bool case_sensitive{false};
+        bool hidden_first{false};
+        // secondary columns, files equal in all of them are ordered by name
+        // so that every file has exactly one position
+        std::vector<sort_column> then;
+
+        bool operator==(const sort_options& other) const noexcept = default;
+    };
+
+    // everything a file is sorted by, for one set of sort_options
+    struct sort_key
+    {
+        // a secondary column, see sort_options::then
+        struct field
+        {
+            i64 number{0};
+            std::string text;
+        };
+
+        u32 group{0};     // directories before or after files, then hidden files
+        i64 number{0};    // size, or time in nanoseconds
+        std::string text; // name, case folded for natural case insensitive sorting, or column text
+        std::vector<field> then; // one for every sort_options::then column
+        std::string_view name;   // the file name, last tie breaker, unique within a directory
+    };
+
+    // sort keys are built on first use and kept until the file or the sort_options change
+    struct sort_key_cache
+    {
+        [[nodiscard]] const sort_key& get(const std::shared_ptr<vfs::file>& file) noexcept;
+        void erase(const vfs::file* file) noexcept;
+        void clear() noexcept;
+
+        [[nodiscard]] const sort_options& options() const noexcept;
+        // drops every cached key if the options differ from the current ones
+        void set_options(const sort_options& options) noexcept;
+
+      private:
+        sort_options options_;
+        std::unordered_map<const vfs::file*, sort_key> keys_;
+    };
+
+    [[nodiscard]] static sort_key make_sort_key(const std::shared_ptr<vfs::file>& file,
+                                                const sort_options& options) noexcept;
+    // same result for every column as comparing the files themselves.
+    // only 0 for keys of the same file.
+    [[nodiscard]] static i32 compare_sort_keys(const sort_key& a, const sort_key& b,
+                                               const sort_options& options) noexcept;
+    // stable sort of files by flat key comparisons, using keys.options().
+    // large lists are sorted in parallel.
+    static void sort_files(std::vector<std::shared_ptr<vfs::file>>& files,
+                           sort_key_cache& keys) noexcept;
+    // sort the rows of a virtual dir, each row is an index into entries.
+    // names are sorted without a stat, size, time, permission and owner columns
+    // statx() every entry, type and mime are sorted by name.
+    static void sort_entry_rows(std::vector<u32>& rows,
+                                const std::span<const vfs::linux::dirent::entry> entries,
+                                const std::filesystem::path& path,
+                                const sort_options& options) noexcept;
+
+    // secondary sort columns as saved in xset::panel::sort_extra,
+    // i.e. "mtime:desc,name" for newest first, then by name.
+    // columns are ascending unless followed by ':desc'. nullopt if a column is unknown.
+    [[nodiscard]] static std::optional<std::vector<sort_column>>
+    parse_sort_columns(const std::string_view spec) noexcept;
+    [[nodiscard]] static std::string
+    format_sort_columns(const std::span<const sort_column> columns) noexcept;
+
     [[nodiscard]] static ptk::file_list* create(const std::shared_ptr<vfs::dir>& dir,
                                                 const bool show_hidden,
                                                 const std::string_view pattern) noexcept;
@@ -71,11 +171,22 @@ struct file_list
 
     /* <private> */
     std::shared_ptr<vfs::dir> dir{nullptr};
-    GList* files{nullptr};
+    // rows in display order
+    std::vector<std::shared_ptr<vfs::file>> files;
+    // row index of every file in files
+    std::unordered_map<const vfs::file*, u32> rows;
+    sort_key_cache sort_keys;
+
+    // rows of a virtual dir, as indexes into dir->entries(), files and rows are unused.
+    // see vfs::dir::is_virtual()
+    bool virtual_dir{false};
+    std::vector<u32> entry_rows;
+    // row of every entry in dir->entries(), hidden_entry_row if not shown
+    std::vector<u32> entry_positions;
+    static constexpr u32 hidden_entry_row{std::numeric_limits<u32>::max()};
 
     bool show_hidden{true};
-    // GObjects do not work with std::string
-    const char* pattern;
+    ptk::file_filter filter;
 
     vfs::file::thumbnail_size thumbnail_size{vfs::file::thumbnail_size::big};
     u64 max_thumbnail{0};
@@ -86,6 +197,7 @@ struct file_list
     bool sort_case{false};
     bool sort_hidden_first{false};
     ptk::file_list::sort_dir sort_dir_{ptk::file_list::sort_dir::mixed};
+    std::vector<sort_column> sort_then;
 
     // Random integer to check whether an iter belongs to our model
     i32 stamp{0};
@@ -95,23 +207,59 @@ struct file_list
     void show_thumbnails(const vfs::file::thumbnail_size size, u64 max_file_size) noexcept;
     void sort() noexcept;
 
-    [[nodiscard]] bool is_pattern_match(const std::filesystem::path& filename) const noexcept;
+    // merge newly listed files into the already sorted list
+    void add_files(const std::span<const std::shared_ptr<vfs::file>> new_files) noexcept;
+
+    [[nodiscard]] bool is_pattern_match(const std::string_view filename) const noexcept;
+    // show only files matching pattern, see ptk::file_filter.
+    // rows are removed and inserted in place, only the files that can change are checked.
+    void set_filter(const std::string_view pattern) noexcept;
+
+    // row of a file in the list, or -1 if the file is not shown
+    [[nodiscard]] i32 find_row(const vfs::file* file) const noexcept;
+    // fill an iter pointing at row
+    void set_iter(GtkTreeIter* iter, const usize row) const noexcept;
+    // number of rows
+    [[nodiscard]] usize size() const noexcept;
+
+    // the sort settings currently applied to the list
+    [[nodiscard]] sort_options current_sort_options() const noexcept;
 
   private:
-    void file_created(const std::shared_ptr<vfs::file>& file) noexcept;
+    // reindex rows starting at row 'from'
+    void update_rows(const usize from = 0) noexcept;
+    // reindex entry_positions
+    void update_entry_positions() noexcept;
+
+    // point sort_keys at the current sort settings
+    void update_sort_options() noexcept;
+    [[nodiscard]] bool sort_less(const std::shared_ptr<vfs::file>& a,
+                                 const std::shared_ptr<vfs::file>& b) noexcept;
+
+    // merge files, already sorted, into the list
+    void merge_files(const std::span<const std::shared_ptr<vfs::file>> added) noexcept;
+    // insert a single file at its sorted position
+    void insert_file(const std::shared_ptr<vfs::file>& file) noexcept;
+
+    // apply one part of a vfs::dir::change_set
+    void insert_files(const std::span<const std::shared_ptr<vfs::file>> created) noexcept;
+    void remove_files(const std::span<const std::shared_ptr<vfs::file>> deleted) noexcept;
+    void update_files(const std::span<const std::shared_ptr<vfs::file>> changed) noexcept;
+    void rename_files(const std::span<const vfs::dir::change_set::renamed_file> renamed) noexcept;
+
     void file_changed(const std::shared_ptr<vfs::file>& file) noexcept;
 
+    void load_thumbnails(const std::span<const std::shared_ptr<vfs::file>> added) noexcept;
+
   public:
     // signals
-    void on_file_list_file_created(const std::shared_ptr<vfs::file>& file) noexcept;
+    void on_file_list_file_changes(const vfs::dir::change_set& changes) noexcept;
     void on_file_list_file_deleted(const std::shared_ptr<vfs::file>& file) noexcept;
-    void on_file_list_file_changed(const std::shared_ptr<vfs::file>& file) noexcept;
     void on_file_list_file_thumbnail_loaded(const std::shared_ptr<vfs::file>& file) noexcept;
 
     // Signals we connect to
-    sigc::connection signal_file_created;
+    sigc::connection signal_file_changes;
     sigc::connection signal_file_deleted;
-    sigc::connection signal_file_changed;
     sigc::connection signal_file_thumbnail_loaded;
 };
 } // namespace ptk
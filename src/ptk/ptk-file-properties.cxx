@@ -453,7 +453,7 @@ init_file_info_tab(const std::shared_ptr<properties_dialog_data>& data,
         try
         {
             target = std::filesystem::read_symlink(file->path());
-            if (!std::filesystem::exists(target))
+            if (file->is_symlink_broken())
             {
                 target = "( broken link )";
             }
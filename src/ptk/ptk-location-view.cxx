@@ -1290,7 +1290,8 @@ ptk::view::location::on_action(GtkWidget* view, const xset_t& set) noexcept
     {
         update_names();
     }
-    else if (set->xset_name == xset::name::dev_change)
+    else if (set->xset_name == xset::name::dev_change ||
+             set->xset_name == xset::name::dev_change_poll)
     {
         update_change_detection();
     }
@@ -1398,6 +1399,7 @@ show_devices_menu(GtkTreeView* view, const std::shared_ptr<vfs::volume>& vol,
 
     xset_set_cb(xset::name::dev_dispname, (GFunc)update_names, nullptr);
     xset_set_cb(xset::name::dev_change, (GFunc)update_change_detection, nullptr);
+    xset_set_cb(xset::name::dev_change_poll, (GFunc)update_change_detection, nullptr);
 
     set = xset_get(xset::name::dev_menu_settings);
     xset_set_submenu(set,
@@ -1406,6 +1408,7 @@ show_devices_menu(GtkTreeView* view, const std::shared_ptr<vfs::volume>& vol,
                          xset::name::separator,
                          xset::name::dev_menu_auto,
                          xset::name::dev_change,
+                         xset::name::dev_change_poll,
                          xset::name::separator,
                          xset::name::dev_single,
                          xset::name::dev_newtab,
@@ -1760,6 +1763,7 @@ ptk::view::location::dev_menu(GtkWidget* parent, ptk::browser* file_browser,
     xset_set_cb(xset::name::dev_ignore_udisks_nopolicy, (GFunc)update_all, nullptr);
     // xset_set_cb(xset::name::dev_automount_volumes, (GFunc)on_automountlist, vol.get());
     xset_set_cb(xset::name::dev_change, (GFunc)update_change_detection, nullptr);
+    xset_set_cb(xset::name::dev_change_poll, (GFunc)update_change_detection, nullptr);
 
     set = xset_get(xset::name::dev_menu_settings);
     xset_set_submenu(set,
@@ -1768,6 +1772,7 @@ ptk::view::location::dev_menu(GtkWidget* parent, ptk::browser* file_browser,
                          xset::name::separator,
                          xset::name::dev_menu_auto,
                          xset::name::dev_change,
+                         xset::name::dev_change_poll,
                          xset::name::dev_newtab,
                      });
 }
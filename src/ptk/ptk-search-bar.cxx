@@ -70,17 +70,14 @@ on_key_press(GtkWidget* entry, GdkEvent* event, void* user_data) noexcept
             {
                 file_browser->select_pattern(text);
             }
-        }
-        else
-        {
-            file_browser->update_model(text);
-        }
 
 #if (GTK_MAJOR_VERSION == 4)
-        gtk_editable_set_text(GTK_EDITABLE(entry), "");
+            gtk_editable_set_text(GTK_EDITABLE(entry), "");
 #elif (GTK_MAJOR_VERSION == 3)
-        gtk_entry_set_text(GTK_ENTRY(entry), "");
+            gtk_entry_set_text(GTK_ENTRY(entry), "");
 #endif
+        }
+        // the filter was already applied while typing, keep it
 
         file_browser->focus(ptk::browser::focus_widget::filelist);
     }
@@ -88,6 +85,28 @@ on_key_press(GtkWidget* entry, GdkEvent* event, void* user_data) noexcept
     return false;
 }
 
+static void
+on_changed(GtkEntry* entry, void* user_data) noexcept
+{
+    (void)user_data;
+
+    if (xset_get_b(xset::name::search_select))
+    {
+        return;
+    }
+
+#if (GTK_MAJOR_VERSION == 4)
+    const std::string text = gtk_editable_get_text(GTK_EDITABLE(entry));
+#elif (GTK_MAJOR_VERSION == 3)
+    const std::string text = gtk_entry_get_text(GTK_ENTRY(entry));
+#endif
+
+    // filter while typing, the file list only rechecks the rows that can change
+    auto* const file_browser =
+        static_cast<ptk::browser*>(g_object_get_data(G_OBJECT(entry), "browser"));
+    file_browser->update_filter(text);
+}
+
 static void
 on_populate_popup(GtkEntry* entry, GtkMenu* menu, ptk::browser* file_browser) noexcept
 {
@@ -127,6 +146,7 @@ ptk::search_bar_new(ptk::browser* file_browser) noexcept
     g_signal_connect(G_OBJECT(entry), "focus-in-event", G_CALLBACK(on_focus_in), nullptr);
     g_signal_connect(G_OBJECT(entry), "focus-out-event", G_CALLBACK(on_focus_out), nullptr);
     g_signal_connect(G_OBJECT(entry), "key-press-event", G_CALLBACK(on_key_press), nullptr);
+    g_signal_connect(G_OBJECT(entry), "changed", G_CALLBACK(on_changed), nullptr);
     g_signal_connect(G_OBJECT(entry), "populate-popup", G_CALLBACK(on_populate_popup), file_browser);
     // clang-format on
 
@@ -136,6 +136,60 @@ config_parse_general(const toml::value& tbl, u64 version) noexcept
         config::settings.thumbnailer_use_api =
             toml::find<bool>(section, config::disk_format::toml::key::thumbnailer_backend.data());
     }
+
+    if (section.contains(config::disk_format::toml::key::dir_load_threads.data()))
+    {
+        config::settings.dir_load_threads =
+            toml::find<u32>(section, config::disk_format::toml::key::dir_load_threads.data());
+    }
+
+    if (section.contains(config::disk_format::toml::key::dir_load_threads_network.data()))
+    {
+        config::settings.dir_load_threads_network =
+            toml::find<u32>(section, config::disk_format::toml::key::dir_load_threads_network.data());
+    }
+
+    if (section.contains(config::disk_format::toml::key::dir_cache_size.data()))
+    {
+        config::settings.dir_cache_size =
+            toml::find<u32>(section, config::disk_format::toml::key::dir_cache_size.data());
+    }
+
+    if (section.contains(config::disk_format::toml::key::dir_cache_memory.data()))
+    {
+        config::settings.dir_cache_memory =
+            toml::find<u64>(section, config::disk_format::toml::key::dir_cache_memory.data());
+    }
+
+    if (section.contains(config::disk_format::toml::key::dir_snapshots.data()))
+    {
+        config::settings.dir_snapshots =
+            toml::find<bool>(section, config::disk_format::toml::key::dir_snapshots.data());
+    }
+
+    if (section.contains(config::disk_format::toml::key::dir_virtual_min_files.data()))
+    {
+        config::settings.dir_virtual_min_files =
+            toml::find<u64>(section, config::disk_format::toml::key::dir_virtual_min_files.data());
+    }
+
+    if (section.contains(config::disk_format::toml::key::file_list_cache_size.data()))
+    {
+        config::settings.file_list_cache_size =
+            toml::find<u32>(section, config::disk_format::toml::key::file_list_cache_size.data());
+    }
+
+    if (section.contains(config::disk_format::toml::key::dir_hot_events.data()))
+    {
+        config::settings.dir_hot_events =
+            toml::find<u32>(section, config::disk_format::toml::key::dir_hot_events.data());
+    }
+
+    if (section.contains(config::disk_format::toml::key::dir_hot_interval.data()))
+    {
+        config::settings.dir_hot_interval =
+            toml::find<u32>(section, config::disk_format::toml::key::dir_hot_interval.data());
+    }
 }
 
 static void
@@ -148,6 +148,15 @@ config::save() noexcept
              {config::disk_format::toml::key::confirm_delete.data(), config::settings.confirm_delete},
              {config::disk_format::toml::key::confirm_trash.data(), config::settings.confirm_trash},
              {config::disk_format::toml::key::thumbnailer_backend.data(), config::settings.thumbnailer_use_api},
+             {config::disk_format::toml::key::dir_load_threads.data(), config::settings.dir_load_threads},
+             {config::disk_format::toml::key::dir_load_threads_network.data(), config::settings.dir_load_threads_network},
+             {config::disk_format::toml::key::dir_cache_size.data(), config::settings.dir_cache_size},
+             {config::disk_format::toml::key::dir_cache_memory.data(), config::settings.dir_cache_memory},
+             {config::disk_format::toml::key::dir_snapshots.data(), config::settings.dir_snapshots},
+             {config::disk_format::toml::key::dir_virtual_min_files.data(), config::settings.dir_virtual_min_files},
+             {config::disk_format::toml::key::file_list_cache_size.data(), config::settings.file_list_cache_size},
+             {config::disk_format::toml::key::dir_hot_events.data(), config::settings.dir_hot_events},
+             {config::disk_format::toml::key::dir_hot_interval.data(), config::settings.dir_hot_interval},
              // clang-format on
          }},
 
@@ -66,6 +66,15 @@ constexpr std::string_view confirm{"confirm"};
 constexpr std::string_view confirm_delete{"confirm_delete"};
 constexpr std::string_view confirm_trash{"confirm_trash"};
 constexpr std::string_view thumbnailer_backend{"thumbnailer_backend"};
+constexpr std::string_view dir_load_threads{"dir_load_threads"};
+constexpr std::string_view dir_load_threads_network{"dir_load_threads_network"};
+constexpr std::string_view dir_cache_size{"dir_cache_size"};
+constexpr std::string_view dir_cache_memory{"dir_cache_memory"};
+constexpr std::string_view dir_snapshots{"dir_snapshots"};
+constexpr std::string_view dir_virtual_min_files{"dir_virtual_min_files"};
+constexpr std::string_view file_list_cache_size{"file_list_cache_size"};
+constexpr std::string_view dir_hot_events{"dir_hot_events"};
+constexpr std::string_view dir_hot_interval{"dir_hot_interval"};
 
 // Window keys
 constexpr std::string_view height{"height"};
@@ -63,6 +63,30 @@ struct settings
     // thumbnailer backend cli/api
     bool thumbnailer_use_api{true};
 
+    // directory loading worker threads, 0 = number of cpus
+    u32 dir_load_threads{0};
+    // worker threads used for network filesystems
+    u32 dir_load_threads_network{1};
+
+    // recently visited directories kept loaded
+    u32 dir_cache_size{8};
+    u64 dir_cache_memory{256 << 20}; // 256 MiB
+
+    // save directory listings to disk, see vfs::dir_snapshot
+    bool dir_snapshots{false};
+
+    // directories with at least this many entries are listed by name only,
+    // see vfs::dir::is_virtual(). 0 = never
+    u64 dir_virtual_min_files{1'000'000};
+
+    // sorted file lists kept for recently left directories, see ptk::file_list_cache
+    u32 file_list_cache_size{4};
+
+    // directories receiving more than this many monitor events per second are
+    // updated every dir_hot_interval milliseconds instead of on each event, 0 = never
+    u32 dir_hot_events{500};
+    u32 dir_hot_interval{1000};
+
     // Git
     bool git_backed_settings{true};
 };
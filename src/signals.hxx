@@ -20,10 +20,11 @@ namespace spacefm
 enum class signal
 {
     // vfs::dir
-    file_created,
+    file_changes,
     file_changed,
     file_deleted,
     file_listed,
+    file_listed_batch,
     file_thumbnail_loaded,
     // file_load_complete,
 
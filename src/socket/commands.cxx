@@ -684,6 +684,14 @@ socket::command(const std::string_view socket_commands_json) noexcept
             }
             file_browser->set_sort_extra(name);
         }
+        else if (property == "sort-then")
+        {
+            const std::string_view value = data[0];
+            if (!file_browser->set_sort_then(value))
+            {
+                return {SOCKET_INVALID, std::format("invalid sort columns '{}'", value)};
+            }
+        }
         else if (property == "show-thumbnails")
         {
             const std::string subproperty = json["subproperty"];
@@ -1194,6 +1202,11 @@ socket::command(const std::string_view socket_commands_json) noexcept
                 return {SOCKET_FAILURE, std::format("unknown property '{}'", property)};
             }
         }
+        else if (property == "sort-then")
+        {
+            return {SOCKET_SUCCESS,
+                    xset_get_s_panel(file_browser->panel(), xset::panel::sort_extra).value_or("")};
+        }
         else if (property == "show-thumbnails")
         {
             return {SOCKET_SUCCESS, std::format("{}", config::settings.show_thumbnails ? 1 : 0)};
@@ -0,0 +1,151 @@
+/**
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+#include <string_view>
+
+#include <filesystem>
+
+#include <vector>
+
+#include <cerrno>
+#include <cstring>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <ztd/ztd.hxx>
+#include <ztd/ztd_logger.hxx>
+
+#include "vfs/linux/dirent.hxx"
+
+// large enough for a few thousand entries per getdents64() call
+static constexpr usize DIRENT_BUFFER_SIZE{256 * 1024};
+
+vfs::linux::dirent::scanner::scanner(const std::filesystem::path& path) noexcept
+{
+    this->fd_ = open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (this->fd_ == -1)
+    {
+        ztd::logger::error("Failed to open directory '{}': {}", path.string(), std::strerror(errno));
+        this->eof_ = true;
+        return;
+    }
+
+    this->buffer_.resize(DIRENT_BUFFER_SIZE);
+}
+
+vfs::linux::dirent::scanner::~scanner() noexcept
+{
+    if (this->fd_ != -1)
+    {
+        close(this->fd_);
+    }
+}
+
+bool
+vfs::linux::dirent::scanner::is_open() const noexcept
+{
+    return this->fd_ != -1;
+}
+
+std::vector<vfs::linux::dirent::entry>
+vfs::linux::dirent::scanner::next() noexcept
+{
+    std::vector<entry> entries;
+
+    while (!this->eof_ && entries.empty())
+    {
+        const auto length = getdents64(this->fd_, this->buffer_.data(), this->buffer_.size());
+        if (length <= 0)
+        {
+            if (length == -1)
+            {
+                ztd::logger::error("getdents64 failed: {}", std::strerror(errno));
+            }
+            this->eof_ = true;
+            break;
+        }
+
+        isize offset = 0;
+        while (offset < length)
+        {
+            const auto* const ent = (dirent64*)(this->buffer_.data() + offset);
+            offset += ent->d_reclen;
+
+            const std::string_view name = ent->d_name;
+            if (name == "." || name == "..")
+            {
+                continue;
+            }
+
+            entries.push_back({std::string(name), ent->d_type});
+        }
+    }
+
+    return entries;
+}
+
+std::vector<vfs::linux::dirent::entry>
+vfs::linux::dirent::scanner::read_all() noexcept
+{
+    std::vector<entry> entries;
+    while (true)
+    {
+        auto batch = this->next();
+        if (batch.empty())
+        {
+            break;
+        }
+        entries.insert(entries.end(),
+                       std::make_move_iterator(batch.begin()),
+                       std::make_move_iterator(batch.end()));
+    }
+    return entries;
+}
+
+bool
+vfs::linux::dirent::scanner::rewind() noexcept
+{
+    if (this->fd_ == -1 || lseek(this->fd_, 0, SEEK_SET) == -1)
+    {
+        return false;
+    }
+    this->eof_ = false;
+    return true;
+}
+
+bool
+vfs::linux::dirent::scanner::stat(entry& ent, struct ::statx& stat) const noexcept
+{
+    const auto result = ::statx(this->fd_,
+                                ent.name.c_str(),
+                                AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT,
+                                statx_mask,
+                                &stat);
+    if (result == -1)
+    {
+        return false;
+    }
+
+    if (ent.type == DT_UNKNOWN)
+    {
+        ent.type = IFTODT(stat.stx_mode);
+    }
+
+    return true;
+}
@@ -0,0 +1,77 @@
+/**
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <string>
+
+#include <filesystem>
+
+#include <vector>
+
+#include <sys/stat.h>
+
+#include <ztd/ztd.hxx>
+
+namespace vfs::linux::dirent
+{
+// statx fields needed to build a vfs::file
+inline constexpr u32 statx_mask{STATX_BASIC_STATS | STATX_BTIME};
+
+struct entry
+{
+    std::string name;
+    u8 type; // d_type, DT_UNKNOWN if the filesystem does not provide it
+};
+
+/**
+ * Bulk directory reader.
+ *
+ * Entries are read with getdents64() into a large buffer and every
+ * entry is stat'ed with a single statx() relative to the open dirfd,
+ * avoiding path resolution from the root for each file.
+ */
+struct scanner
+{
+    scanner() = delete;
+    scanner(const std::filesystem::path& path) noexcept;
+    ~scanner() noexcept;
+    scanner(const scanner& other) = delete;
+    scanner(scanner&& other) = delete;
+    scanner& operator=(const scanner& other) = delete;
+    scanner& operator=(scanner&& other) = delete;
+
+    [[nodiscard]] bool is_open() const noexcept;
+
+    // read the next buffer worth of entries, empty when the directory has been fully read.
+    // '.' and '..' are never returned. entries are not stat'ed.
+    [[nodiscard]] std::vector<entry> next() noexcept;
+
+    // read every remaining entry, entries are not stat'ed.
+    [[nodiscard]] std::vector<entry> read_all() noexcept;
+
+    // read the directory again from the first entry
+    [[nodiscard]] bool rewind() noexcept;
+
+    // statx() an entry relative to the directory, does not follow symlinks.
+    // returns false on failure with errno set, ENOENT if the entry no longer exists.
+    [[nodiscard]] bool stat(entry& ent, struct ::statx& stat) const noexcept;
+
+  private:
+    i32 fd_{-1};
+    bool eof_{false};
+    std::vector<char> buffer_;
+};
+} // namespace vfs::linux::dirent
@@ -32,6 +32,8 @@
 
 #include <algorithm>
 
+#include <system_error>
+
 #include <fcntl.h>
 
 #include <glibmm.h>
@@ -65,8 +67,25 @@ is_data_plain_text(const std::span<const std::byte> data) noexcept
 const std::string
 vfs::detail::mime_type::get_by_file(const std::filesystem::path& path) noexcept
 {
-    const auto status = std::filesystem::status(path);
+    std::error_code ec;
+    const auto status = std::filesystem::status(path, ec);
+
+    if (!std::filesystem::exists(status))
+    {
+        return vfs::constants::mime_type::unknown.data();
+    }
 
+    const auto file_size =
+        std::filesystem::is_regular_file(status) ? std::filesystem::file_size(path, ec) : 0;
+
+    return vfs::detail::mime_type::get_by_file(path, status, file_size);
+}
+
+const std::string
+vfs::detail::mime_type::get_by_file(const std::filesystem::path& path,
+                                    const std::filesystem::file_status& status,
+                                    const u64 file_size) noexcept
+{
     if (!std::filesystem::exists(status))
     {
         return vfs::constants::mime_type::unknown.data();
@@ -88,7 +107,6 @@ vfs::detail::mime_type::get_by_file(const std::filesystem::path& path) noexcept
         return type;
     }
 
-    const auto file_size = std::filesystem::file_size(path);
     if (file_size == 0 || std::filesystem::is_other(status))
     {
         // empty file can be viewed as text file
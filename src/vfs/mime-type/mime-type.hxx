@@ -24,6 +24,8 @@
 
 #include <array>
 
+#include <ztd/ztd.hxx>
+
 namespace vfs::detail::mime_type
 {
 /*
@@ -33,6 +35,10 @@ namespace vfs::detail::mime_type
  * the file will be checked, which is much more time-consuming.
  */
 [[nodiscard]] const std::string get_by_file(const std::filesystem::path& path) noexcept;
+// same as above but uses an already known file status and size
+[[nodiscard]] const std::string get_by_file(const std::filesystem::path& path,
+                                            const std::filesystem::file_status& status,
+                                            const u64 size) noexcept;
 
 [[nodiscard]] bool is_text(const std::string_view mime_type) noexcept;
 [[nodiscard]] bool is_executable(const std::string_view mime_type) noexcept;
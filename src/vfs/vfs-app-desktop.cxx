@@ -29,6 +29,8 @@
 #include <vector>
 #include <unordered_map>
 
+#include <mutex>
+
 #include <optional>
 
 #include <memory>
@@ -57,14 +59,25 @@ struct desktop_cache_data
 };
 
 std::unordered_map<std::filesystem::path, desktop_cache_data> desktops_cache;
+// desktop files are loaded from the directory loading worker threads
+std::mutex desktops_cache_lock;
 
 const std::shared_ptr<vfs::desktop>
 vfs::desktop::create(const std::filesystem::path& desktop_file) noexcept
 {
-    if (desktops_cache.contains(desktop_file))
+    std::optional<desktop_cache_data> cached{std::nullopt};
+    {
+        const std::scoped_lock<std::mutex> lock(desktops_cache_lock);
+        if (desktops_cache.contains(desktop_file))
+        {
+            cached = desktops_cache.at(desktop_file);
+        }
+    }
+
+    if (cached)
     {
         // ztd::logger::info("vfs::desktop({})  cache   {}", ztd::logger::utils::ptr(desktop), desktop_file.string());
-        const auto cache = desktops_cache.at(desktop_file);
+        const auto& cache = cached.value();
 
         const auto desktop_stat = ztd::stat(cache.desktop->path());
         if (desktop_stat.mtime() == cache.desktop_mtime)
@@ -74,7 +87,11 @@ vfs::desktop::create(const std::filesystem::path& desktop_file) noexcept
         // ztd::logger::info("vfs::desktop({}) changed on disk, reloading", ztd::logger::utils::ptr(desktop));
     }
     const auto desktop = std::make_shared<vfs::desktop>(desktop_file);
-    desktops_cache.insert({desktop_file, {desktop, ztd::stat(desktop->path()).mtime()}});
+    const desktop_cache_data data{desktop, ztd::stat(desktop->path()).mtime()};
+    {
+        const std::scoped_lock<std::mutex> lock(desktops_cache_lock);
+        desktops_cache.insert_or_assign(desktop_file, data);
+    }
     // ztd::logger::info("vfs::desktop({})  new     {}", ztd::logger::utils::ptr(desktop), desktop_file.string());
     return desktop;
 }
@@ -0,0 +1,166 @@
+/**
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+#include <list>
+
+#include <optional>
+
+#include <algorithm>
+
+#include <mutex>
+
+#include <memory>
+
+#include <ztd/ztd.hxx>
+#include <ztd/ztd_logger.hxx>
+
+#include "settings/settings.hxx"
+
+#include "vfs/vfs-dir.hxx"
+
+#include "vfs/vfs-dir-cache.hxx"
+
+namespace
+{
+struct cache_entry
+{
+    std::shared_ptr<vfs::dir> dir;
+    // footprint of the dir, computed once it is idle, see vfs::dir::memory_usage()
+    std::optional<u64> memory{std::nullopt};
+};
+} // namespace
+
+namespace global
+{
+// most recently used at the front
+std::list<cache_entry> dir_lru_cache;
+std::mutex dir_lru_cache_lock;
+vfs::dir_cache::stats_data dir_cache_stats;
+} // namespace global
+
+// the cache holds the only reference, no browser is using this dir
+static bool
+is_idle(const cache_entry& entry) noexcept
+{
+    return entry.dir.use_count() == 1;
+}
+
+void
+vfs::dir_cache::touch(const std::shared_ptr<vfs::dir>& dir) noexcept
+{
+    {
+        const std::scoped_lock<std::mutex> lock(global::dir_lru_cache_lock);
+
+        // the dir is in use again, its footprint is computed the next time it is idle
+        std::erase_if(global::dir_lru_cache,
+                      [&dir](const cache_entry& entry) { return entry.dir == dir; });
+
+        // network filesystems are not monitored for changes, always reread them
+        if (!dir->avoid_changes())
+        {
+            global::dir_lru_cache.push_front({dir});
+        }
+    }
+
+    vfs::dir_cache::trim();
+}
+
+void
+vfs::dir_cache::record_hit() noexcept
+{
+    const std::scoped_lock<std::mutex> lock(global::dir_lru_cache_lock);
+    global::dir_cache_stats.hits++;
+}
+
+void
+vfs::dir_cache::record_miss() noexcept
+{
+    const std::scoped_lock<std::mutex> lock(global::dir_lru_cache_lock);
+    global::dir_cache_stats.misses++;
+}
+
+void
+vfs::dir_cache::trim() noexcept
+{
+    const usize max_dirs = config::settings.dir_cache_size;
+    const u64 max_memory = config::settings.dir_cache_memory;
+
+    // dirs are released after the lock so that their
+    // destructors do not run while the cache is locked
+    std::vector<std::shared_ptr<vfs::dir>> evicted;
+    {
+        const std::scoped_lock<std::mutex> lock(global::dir_lru_cache_lock);
+
+        usize idle_dirs = 0;
+        u64 idle_memory = 0;
+        for (auto it = global::dir_lru_cache.begin(); it != global::dir_lru_cache.end();)
+        {
+            if (!is_idle(*it))
+            { // in use dirs do not count against the cache limits
+                it->memory = std::nullopt;
+                ++it;
+                continue;
+            }
+
+            if (!it->memory)
+            { // walking the files is only done once per idle period
+                it->memory = it->dir->memory_usage();
+            }
+
+            const auto memory = it->memory.value();
+            if (idle_dirs + 1 > max_dirs || idle_memory + memory > max_memory)
+            {
+                evicted.push_back(it->dir);
+                it = global::dir_lru_cache.erase(it);
+                global::dir_cache_stats.evictions++;
+                continue;
+            }
+
+            idle_dirs += 1;
+            idle_memory += memory;
+            ++it;
+        }
+
+        global::dir_cache_stats.dirs = global::dir_lru_cache.size();
+        global::dir_cache_stats.memory = idle_memory;
+    }
+
+    for (const auto& dir : evicted)
+    {
+        ztd::logger::debug("vfs::dir_cache evicted {}", dir->path().string());
+    }
+}
+
+void
+vfs::dir_cache::clear() noexcept
+{
+    std::list<cache_entry> cached;
+    {
+        const std::scoped_lock<std::mutex> lock(global::dir_lru_cache_lock);
+
+        std::swap(cached, global::dir_lru_cache);
+
+        global::dir_cache_stats.dirs = 0;
+        global::dir_cache_stats.memory = 0;
+    }
+}
+
+vfs::dir_cache::stats_data
+vfs::dir_cache::stats() noexcept
+{
+    const std::scoped_lock<std::mutex> lock(global::dir_lru_cache_lock);
+    return global::dir_cache_stats;
+}
@@ -0,0 +1,57 @@
+/**
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include <ztd/ztd.hxx>
+
+#include "vfs/vfs-dir.hxx"
+
+/**
+ * Keeps recently visited directories loaded after the last
+ * reference to them has been dropped, so that going back to a
+ * directory does not have to read it again.
+ *
+ * Directories are evicted in least recently used order once there
+ * are more than config::settings.dir_cache_size idle directories or
+ * the idle directories use more than config::settings.dir_cache_memory bytes.
+ */
+namespace vfs::dir_cache
+{
+struct stats_data
+{
+    u64 hits{0};      // vfs::dir::create() returned an already loaded dir
+    u64 misses{0};    // vfs::dir::create() had to read the dir
+    u64 evictions{0}; // idle dirs dropped from the cache
+    usize dirs{0};    // dirs currently held by the cache
+    u64 memory{0};    // approximate memory used by idle dirs held by the cache
+};
+
+// mark a dir as the most recently used and evict as needed
+void touch(const std::shared_ptr<vfs::dir>& dir) noexcept;
+
+void record_hit() noexcept;
+void record_miss() noexcept;
+
+// evict idle dirs until the cache is within its limits
+void trim() noexcept;
+
+// drop every cached dir
+void clear() noexcept;
+
+[[nodiscard]] vfs::dir_cache::stats_data stats() noexcept;
+} // namespace vfs::dir_cache
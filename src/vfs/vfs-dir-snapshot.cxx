@@ -0,0 +1,440 @@
+/**
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+#include <string_view>
+
+#include <format>
+
+#include <filesystem>
+
+#include <span>
+
+#include <array>
+
+#include <vector>
+
+#include <algorithm>
+
+#include <chrono>
+
+#include <mutex>
+
+#include <optional>
+
+#include <memory>
+
+#include <fstream>
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <ztd/ztd.hxx>
+#include <ztd/ztd_logger.hxx>
+
+#include "concurrency.hxx"
+
+#include "vfs/vfs-file.hxx"
+#include "vfs/vfs-mime-type.hxx"
+#include "vfs/vfs-user-dirs.hxx"
+
+#include "vfs/vfs-dir-snapshot.hxx"
+
+// bump when the layout of snapshot_header or snapshot_record changes
+static constexpr u32 SNAPSHOT_VERSION{3};
+static constexpr std::array<char, 8> SNAPSHOT_MAGIC{'S', 'F', 'M', 'S', 'N', 'A', 'P', '\0'};
+
+struct snapshot_header
+{
+    std::array<char, 8> magic;
+    u32 version;
+    u32 count; // number of snapshot_record
+    u32 dev_major;
+    u32 dev_minor;
+    u64 ino;
+    struct ::statx_timestamp mtime;
+    struct ::statx_timestamp ctime;
+    u64 strings_size; // size of the string table after the records
+    u32 path_offset;  // path of the directory, in the string table
+    u32 path_size;
+};
+
+struct snapshot_record
+{
+    u32 name_offset; // offsets into the string table
+    u32 name_size;
+    u32 mime_type_offset;
+    u32 mime_type_size;
+    u32 mode;
+    u32 uid;
+    u32 gid;
+    u64 ino;
+    u64 size;
+    u64 blocks;
+    u64 attributes;
+    struct ::statx_timestamp atime;
+    struct ::statx_timestamp btime;
+    struct ::statx_timestamp ctime;
+    struct ::statx_timestamp mtime;
+};
+
+// snapshots that have not been saved again for this long are removed
+static constexpr std::chrono::days snapshot_max_age{30};
+// the least recently saved snapshots are removed once all of them use more than this
+static constexpr u64 snapshot_max_size{64 * 1024 * 1024};
+// how often save() checks for snapshots to remove
+static constexpr std::chrono::hours snapshot_prune_interval{1};
+
+static const std::filesystem::path
+snapshot_dir() noexcept
+{
+    // not under vfs::program::tmp(), that is removed on exit
+    return vfs::user::cache() / std::format("{}-snapshots", PACKAGE_NAME);
+}
+
+static const std::filesystem::path
+snapshot_path(const struct ::statx& dir_stat) noexcept
+{
+    return snapshot_dir() / std::format("{:x}-{:x}-{:x}",
+                                        dir_stat.stx_dev_major,
+                                        dir_stat.stx_dev_minor,
+                                        dir_stat.stx_ino);
+}
+
+// the directory a snapshot was saved for has been removed, or its path is now another directory
+static bool
+is_orphan(const std::filesystem::path& snapshot) noexcept
+{
+    const auto fd = open(snapshot.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        return false;
+    }
+
+    bool orphan = true;
+    snapshot_header header;
+    if (read(fd, &header, sizeof(header)) == sizeof(header) && header.magic == SNAPSHOT_MAGIC &&
+        header.version == SNAPSHOT_VERSION)
+    {
+        const auto offset =
+            sizeof(header) + ((u64)header.count * sizeof(snapshot_record)) + header.path_offset;
+        std::string path(header.path_size, '\0');
+        if (pread(fd, path.data(), path.size(), (off_t)offset) == (isize)path.size())
+        {
+            struct ::statx dir_stat;
+            const auto result =
+                ::statx(AT_FDCWD, path.c_str(), AT_NO_AUTOMOUNT, STATX_INO, &dir_stat);
+            if (result == 0)
+            {
+                orphan = header.dev_major != dir_stat.stx_dev_major ||
+                         header.dev_minor != dir_stat.stx_dev_minor ||
+                         header.ino != dir_stat.stx_ino;
+            }
+            else
+            { // keep the snapshot if the directory only could not be reached
+                orphan = errno == ENOENT || errno == ENOTDIR;
+            }
+        }
+    }
+
+    close(fd);
+    return orphan;
+}
+
+static void
+prune() noexcept
+{
+    struct snapshot_file
+    {
+        std::filesystem::path path;
+        std::filesystem::file_time_type mtime;
+        u64 size;
+    };
+
+    const auto now = std::filesystem::file_time_type::clock::now();
+
+    u64 removed = 0;
+    u64 total_size = 0;
+    std::vector<snapshot_file> snapshots;
+
+    std::error_code ec;
+    for (const auto& dfile : std::filesystem::directory_iterator(snapshot_dir(), ec))
+    {
+        std::error_code file_ec;
+        const auto mtime = dfile.last_write_time(file_ec);
+        const auto size = dfile.file_size(file_ec);
+        if (file_ec)
+        {
+            continue;
+        }
+
+        if (dfile.path().extension() == ".tmp")
+        { // only remove temp files that were left behind, not ones being written
+            if (now - mtime > snapshot_prune_interval)
+            {
+                std::filesystem::remove(dfile.path(), file_ec);
+            }
+            continue;
+        }
+
+        if (now - mtime > snapshot_max_age || is_orphan(dfile.path()))
+        {
+            std::filesystem::remove(dfile.path(), file_ec);
+            removed += 1;
+            continue;
+        }
+
+        snapshots.push_back({dfile.path(), mtime, size});
+        total_size += size;
+    }
+
+    // a snapshot is saved again every time it is used, the oldest mtime is the least recently used
+    std::ranges::sort(snapshots, std::less{}, &snapshot_file::mtime);
+    for (const auto& snapshot : snapshots)
+    {
+        if (total_size <= snapshot_max_size)
+        {
+            break;
+        }
+
+        std::filesystem::remove(snapshot.path, ec);
+        total_size -= snapshot.size;
+        removed += 1;
+    }
+
+    if (removed != 0)
+    {
+        ztd::logger::debug("Removed {} directory snapshots", removed);
+    }
+}
+
+// run prune() in the background, at most once every snapshot_prune_interval
+static void
+schedule_prune() noexcept
+{
+    static std::mutex prune_lock;
+    static std::optional<std::chrono::steady_clock::time_point> last_prune{std::nullopt};
+
+    {
+        const std::scoped_lock<std::mutex> lock(prune_lock);
+
+        const auto now = std::chrono::steady_clock::now();
+        if (last_prune && now - last_prune.value() < snapshot_prune_interval)
+        {
+            return;
+        }
+        last_prune = now;
+    }
+
+    global::runtime.background_executor()->post(prune);
+}
+
+static bool
+is_same_timestamp(const struct ::statx_timestamp& a, const struct ::statx_timestamp& b) noexcept
+{
+    return a.tv_sec == b.tv_sec && a.tv_nsec == b.tv_nsec;
+}
+
+std::optional<std::vector<vfs::dir_snapshot::entry>>
+vfs::dir_snapshot::load(const std::filesystem::path& path, const struct ::statx& dir_stat) noexcept
+{
+    const auto snapshot = snapshot_path(dir_stat);
+
+    const auto fd = open(snapshot.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        return std::nullopt;
+    }
+
+    struct stat snapshot_stat;
+    if (fstat(fd, &snapshot_stat) == -1 || (usize)snapshot_stat.st_size < sizeof(snapshot_header))
+    {
+        close(fd);
+        return std::nullopt;
+    }
+    const auto snapshot_size = (usize)snapshot_stat.st_size;
+
+    void* data = mmap(nullptr, snapshot_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        return std::nullopt;
+    }
+
+    std::optional<std::vector<entry>> entries{std::nullopt};
+
+    const auto* const bytes = static_cast<const char*>(data);
+    snapshot_header header;
+    std::memcpy(&header, bytes, sizeof(header));
+
+    const auto records_size = (u64)header.count * sizeof(snapshot_record);
+    const bool is_valid =
+        header.magic == SNAPSHOT_MAGIC && header.version == SNAPSHOT_VERSION &&
+        header.dev_major == dir_stat.stx_dev_major && header.dev_minor == dir_stat.stx_dev_minor &&
+        header.ino == dir_stat.stx_ino && is_same_timestamp(header.mtime, dir_stat.stx_mtime) &&
+        is_same_timestamp(header.ctime, dir_stat.stx_ctime) &&
+        sizeof(header) + records_size + header.strings_size == snapshot_size;
+    if (is_valid)
+    {
+        const auto* const records = bytes + sizeof(header);
+        const std::string_view strings(records + records_size, header.strings_size);
+
+        std::vector<entry> loaded;
+        loaded.reserve(header.count);
+        for (u32 i = 0; i < header.count; ++i)
+        {
+            snapshot_record record;
+            std::memcpy(&record, records + (i * sizeof(snapshot_record)), sizeof(record));
+
+            if ((u64)record.name_offset + record.name_size > strings.size() ||
+                (u64)record.mime_type_offset + record.mime_type_size > strings.size())
+            {
+                ztd::logger::warn("Corrupt directory snapshot: {}", snapshot.string());
+                loaded.clear();
+                break;
+            }
+
+            entry ent;
+            ent.name = strings.substr(record.name_offset, record.name_size);
+            ent.mime_type = strings.substr(record.mime_type_offset, record.mime_type_size);
+            ent.stat.size = record.size;
+            ent.stat.blocks = record.blocks;
+            ent.stat.ino = record.ino;
+            ent.stat.attributes = record.attributes;
+            ent.stat.atime = record.atime;
+            ent.stat.btime = record.btime;
+            ent.stat.ctime = record.ctime;
+            ent.stat.mtime = record.mtime;
+            ent.stat.uid = record.uid;
+            ent.stat.gid = record.gid;
+            ent.stat.mode = (u16)record.mode;
+
+            loaded.push_back(std::move(ent));
+        }
+
+        if (loaded.size() == header.count)
+        {
+            entries = std::move(loaded);
+        }
+    }
+
+    munmap(data, snapshot_size);
+
+    if (entries)
+    {
+        ztd::logger::debug("Loaded directory snapshot for {}", path.string());
+    }
+
+    return entries;
+}
+
+void
+vfs::dir_snapshot::save(const std::filesystem::path& path, const struct ::statx& dir_stat,
+                        const std::span<const entry> entries) noexcept
+{
+    const auto snapshot = snapshot_path(dir_stat);
+
+    std::error_code ec;
+    std::filesystem::create_directories(snapshot.parent_path(), ec);
+    if (ec)
+    {
+        ztd::logger::error("Failed to create {}: {}",
+                           snapshot.parent_path().string(),
+                           ec.message());
+        return;
+    }
+
+    // the directory path is kept so that prune() can tell when the directory is gone
+    std::string strings = path.native();
+    std::vector<snapshot_record> records;
+    records.reserve(entries.size());
+    for (const auto& ent : entries)
+    {
+        const auto& stat = ent.stat;
+
+        snapshot_record record{};
+        record.name_offset = (u32)strings.size();
+        record.name_size = (u32)ent.name.size();
+        strings.append(ent.name);
+        record.mime_type_offset = (u32)strings.size();
+        record.mime_type_size = (u32)ent.mime_type.size();
+        strings.append(ent.mime_type);
+        record.mode = stat.mode;
+        record.uid = stat.uid;
+        record.gid = stat.gid;
+        record.ino = stat.ino;
+        record.size = stat.size;
+        record.blocks = stat.blocks;
+        record.attributes = stat.attributes;
+        record.atime = stat.atime;
+        record.btime = stat.btime;
+        record.ctime = stat.ctime;
+        record.mtime = stat.mtime;
+
+        records.push_back(record);
+    }
+
+    snapshot_header header{};
+    header.magic = SNAPSHOT_MAGIC;
+    header.version = SNAPSHOT_VERSION;
+    header.count = (u32)records.size();
+    header.dev_major = dir_stat.stx_dev_major;
+    header.dev_minor = dir_stat.stx_dev_minor;
+    header.ino = dir_stat.stx_ino;
+    header.mtime = dir_stat.stx_mtime;
+    header.ctime = dir_stat.stx_ctime;
+    header.strings_size = strings.size();
+    header.path_offset = 0;
+    header.path_size = (u32)path.native().size();
+
+    // write to a temp file and rename, a reader never sees a partial snapshot
+    const auto tmp_snapshot = std::filesystem::path(std::format("{}.tmp", snapshot.string()));
+    {
+        std::ofstream file(tmp_snapshot, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            ztd::logger::error("Failed to open the file: {}", tmp_snapshot.string());
+            return;
+        }
+
+        file.write((const char*)&header, sizeof(header));
+        file.write((const char*)records.data(),
+                   (std::streamsize)(records.size() * sizeof(snapshot_record)));
+        file.write(strings.data(), (std::streamsize)strings.size());
+        if (!file)
+        {
+            ztd::logger::error("Failed to write the file: {}", tmp_snapshot.string());
+            std::filesystem::remove(tmp_snapshot, ec);
+            return;
+        }
+    }
+
+    std::filesystem::rename(tmp_snapshot, snapshot, ec);
+    if (ec)
+    {
+        ztd::logger::error("Failed to save directory snapshot for {}: {}",
+                           path.string(),
+                           ec.message());
+        std::filesystem::remove(tmp_snapshot, ec);
+        return;
+    }
+
+    schedule_prune();
+}
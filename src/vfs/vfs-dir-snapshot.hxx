@@ -0,0 +1,70 @@
+/**
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <string>
+
+#include <filesystem>
+
+#include <span>
+
+#include <vector>
+
+#include <optional>
+
+#include <memory>
+
+#include <sys/stat.h>
+
+#include <ztd/ztd.hxx>
+
+#include "vfs/vfs-file.hxx"
+
+/**
+ * Persistent directory listings.
+ *
+ * A snapshot stores the name, statx data and mime type of every file
+ * in a directory so that it can be shown without reading the directory
+ * again. Snapshots are keyed by the device and inode of the directory and
+ * are only valid while the mtime and ctime of the directory are unchanged.
+ *
+ * Snapshots of directories that no longer exist, and snapshots that have
+ * not been saved for a month, are removed. Once all snapshots use more than
+ * 64 MiB the least recently saved ones are removed as well.
+ *
+ * The on disk format is a fixed size header, followed by a fixed size
+ * record for every file, followed by a string table, so that a snapshot
+ * can be used directly from a read only mmap().
+ */
+namespace vfs::dir_snapshot
+{
+struct entry
+{
+    std::string name;
+    vfs::file::stat_data stat;
+    std::string mime_type;
+};
+
+// load the snapshot for a directory, std::nullopt if there is no valid snapshot.
+// dir_stat is the current statx() of the directory.
+[[nodiscard]] std::optional<std::vector<entry>>
+load(const std::filesystem::path& path, const struct ::statx& dir_stat) noexcept;
+
+// save a snapshot of a directory, dir_stat must be from before the directory was read.
+// entries are copies, the vfs::file objects may be updated by the main loop meanwhile.
+void save(const std::filesystem::path& path, const struct ::statx& dir_stat,
+          const std::span<const entry> entries) noexcept;
+} // namespace vfs::dir_snapshot
@@ -14,14 +14,22 @@
  */
 
 #include <string>
+#include <string_view>
 
 #include <format>
 
 #include <filesystem>
 
+#include <span>
+
 #include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <list>
 
 #include <algorithm>
+#include <ranges>
 
 #include <mutex>
 
@@ -31,10 +39,22 @@
 
 #include <chrono>
 
+#include <cmath>
+
+#include <thread>
+
 #include <functional>
 
+#include <utility>
+
 #include <fstream>
 
+#include <cerrno>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
 #include <glibmm.h>
 
 #include <ztd/ztd.hxx>
@@ -42,13 +62,20 @@
 
 #include "concurrency.hxx"
 
+#include "settings/settings.hxx"
+
 #include "utils/memory.hxx"
 #include "utils/write.hxx"
 
+#include "vfs/vfs-dir-cache.hxx"
+#include "vfs/vfs-dir-snapshot.hxx"
 #include "vfs/vfs-file.hxx"
+#include "vfs/vfs-mime-type.hxx"
 #include "vfs/vfs-thumbnailer.hxx"
 #include "vfs/vfs-volume.hxx"
 
+#include "vfs/linux/dirent.hxx"
+
 #include "vfs/vfs-dir.hxx"
 
 namespace global
@@ -69,10 +96,11 @@ vfs::dir::~dir() noexcept
 
     this->signal_task_load_dir.disconnect();
 
-    this->evt_file_created.clear();
+    this->evt_file_changes.clear();
     this->evt_file_changed.clear();
     this->evt_file_deleted.clear();
     this->evt_file_listed.clear();
+    this->evt_file_listed_batch.clear();
     this->evt_file_thumbnail_loaded.clear();
 
     if (this->change_notify_timeout)
@@ -80,7 +108,14 @@ vfs::dir::~dir() noexcept
         g_source_remove(this->change_notify_timeout);
     }
 
+    this->cancel_poll();
+
     this->executor_result_.get().get();
+
+    if (this->listed_notify_idle)
+    {
+        g_source_remove(this->listed_notify_idle);
+    }
 }
 
 const std::shared_ptr<vfs::dir>
@@ -90,6 +125,7 @@ vfs::dir::create(const std::filesystem::path& path) noexcept
     if (global::dir_smart_cache.contains(path))
     {
         dir = global::dir_smart_cache.at(path);
+        vfs::dir_cache::record_hit();
         // ztd::logger::debug("vfs::dir::dir({}) cache   {}", ztd::logger::utils::ptr(dir.get()), this->path_.string());
     }
     else
@@ -99,7 +135,9 @@ vfs::dir::create(const std::filesystem::path& path) noexcept
             std::bind([](const auto& path) { return std::make_shared<vfs::dir>(path); }, path));
         // ztd::logger::debug("vfs::dir::dir({}) new     {}", ztd::logger::utils::ptr(dir.get()), this->path_.string());
         dir->post_initialize();
+        vfs::dir_cache::record_miss();
     }
+    vfs::dir_cache::touch(dir);
     // ztd::logger::debug("dir({})     {}", ztd::logger::utils::ptr(dir.get()), path.string());
     return dir;
 }
@@ -127,6 +165,95 @@ vfs::dir::files() const noexcept
     return this->files_;
 }
 
+bool
+vfs::dir::contains(const std::string_view filename) noexcept
+{
+    const std::scoped_lock<std::mutex> files_lock(this->files_lock_);
+
+    return this->files_index_.contains(filename);
+}
+
+bool
+vfs::dir::is_virtual() const noexcept
+{
+    return this->virtual_;
+}
+
+const std::span<const vfs::linux::dirent::entry>
+vfs::dir::entries() const noexcept
+{
+    return this->entries_;
+}
+
+// materialized files kept for a virtual dir, enough for a few screens of rows
+// and the files used by the last sort
+static constexpr usize recent_files_max{16384};
+
+const std::shared_ptr<vfs::file>
+vfs::dir::materialize(const std::string_view filename) noexcept
+{
+    const std::scoped_lock<std::mutex> files_lock(this->files_lock_);
+
+    const auto it = this->recent_files_index_.find(filename);
+    if (it != this->recent_files_index_.cend())
+    {
+        this->recent_files_.splice(this->recent_files_.begin(), this->recent_files_, it->second);
+        return this->recent_files_.front();
+    }
+
+    const auto path = this->path_ / filename;
+    struct ::statx stat{};
+    if (::statx(AT_FDCWD,
+                path.c_str(),
+                AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT,
+                vfs::linux::dirent::statx_mask,
+                &stat) == -1)
+    { // deleted since the names were read
+        return nullptr;
+    }
+
+    if (this->recent_files_.size() >= recent_files_max)
+    {
+        this->recent_files_index_.erase(this->recent_files_.back()->name());
+        this->recent_files_.pop_back();
+    }
+
+    this->recent_files_.push_front(vfs::file::create(path, stat));
+    this->recent_files_index_.insert({this->recent_files_.front()->name(),
+                                      this->recent_files_.begin()});
+    return this->recent_files_.front();
+}
+
+void
+vfs::dir::add_file(const std::shared_ptr<vfs::file>& file) noexcept
+{
+    this->files_.push_back(file);
+    this->files_index_.insert_or_assign(std::string(file->name()), file);
+}
+
+void
+vfs::dir::remove_file(const std::shared_ptr<vfs::file>& file) noexcept
+{
+    // TODO - FIXME - using std::ranges::remove here will
+    // caues a segfault when deleting/moving/loading thumbails
+    // std::ranges::remove(this->files_, file);
+    this->files_.erase(std::remove(this->files_.begin(), this->files_.end(), file),
+                       this->files_.end());
+
+    const auto it = this->files_index_.find(file->name());
+    if (it != this->files_index_.cend() && it->second == file)
+    {
+        this->files_index_.erase(it);
+    }
+}
+
+void
+vfs::dir::clear_files() noexcept
+{
+    this->files_.clear();
+    this->files_index_.clear();
+}
+
 bool
 vfs::dir::avoid_changes() const noexcept
 {
@@ -143,6 +270,223 @@ void
 vfs::dir::update_avoid_changes() noexcept
 {
     this->avoid_changes_ = vfs::volume_dir_avoid_changes(this->path_);
+
+    const auto interval = this->avoid_changes_ ? vfs::volume_dir_poll_interval(this->path_)
+                                               : std::chrono::seconds(0);
+    if (interval == this->poll_interval_)
+    {
+        return;
+    }
+    this->poll_interval_ = interval;
+
+    if (this->is_polled())
+    {
+        this->poll_delay_ = interval;
+        if (!this->poll_running_)
+        {
+            this->schedule_poll(interval);
+        }
+    }
+    else
+    {
+        this->cancel_poll();
+    }
+}
+
+bool
+vfs::dir::is_polled() const noexcept
+{
+    return this->poll_interval_.count() != 0;
+}
+
+// a check that has not returned after this long is logged,
+// no second check is started for the dir until it returns
+static constexpr std::chrono::seconds poll_timeout{30};
+
+static bool
+on_poll_timer(void* user_data) noexcept
+{
+    auto* const dir = static_cast<vfs::dir*>(user_data);
+
+    dir->poll_timer = 0;
+    dir->poll();
+
+    return false;
+}
+
+static bool
+on_poll_result(void* user_data) noexcept
+{
+    const std::unique_ptr<vfs::dir::poll_result> result(
+        static_cast<vfs::dir::poll_result*>(user_data));
+
+    const auto dir = result->dir.lock();
+    if (dir)
+    {
+        dir->apply_poll(*result);
+    }
+
+    return false;
+}
+
+static bool
+is_same_timestamp(const struct ::statx_timestamp& a, const struct ::statx_timestamp& b) noexcept
+{
+    return a.tv_sec == b.tv_sec && a.tv_nsec == b.tv_nsec;
+}
+
+void
+vfs::dir::schedule_poll(const std::chrono::seconds delay) noexcept
+{
+    this->cancel_poll();
+
+    this->poll_timer = g_timeout_add_seconds_full(G_PRIORITY_LOW,
+                                                  static_cast<u32>(delay.count()),
+                                                  (GSourceFunc)on_poll_timer,
+                                                  this,
+                                                  nullptr);
+}
+
+void
+vfs::dir::cancel_poll() noexcept
+{
+    if (this->poll_timer)
+    {
+        g_source_remove(this->poll_timer);
+        this->poll_timer = 0;
+    }
+}
+
+void
+vfs::dir::poll() noexcept
+{
+    if (this->shutdown_ || !this->is_polled() || this->virtual_)
+    {
+        return;
+    }
+
+    if (this->poll_running_)
+    { // the timeout guard, apply_poll() schedules the next check once this one returns
+        if (!this->poll_stalled_)
+        {
+            this->poll_stalled_ = true;
+            ztd::logger::warn("Change polling for {} has not returned after {}s",
+                              this->path_.string(),
+                              poll_timeout.count());
+        }
+        return;
+    }
+
+    if (this->is_loading())
+    {
+        this->schedule_poll(this->poll_delay_);
+        return;
+    }
+
+    this->poll_running_ = true;
+    this->poll_started_ = std::chrono::steady_clock::now();
+
+    // the check only holds a weak reference, a hung server keeps
+    // a background thread busy but never the dir or the main loop
+    global::runtime.background_executor()->post(
+        [dir = this->weak_from_this(), path = this->path_, last = this->poll_stamp_]
+        {
+            auto* const result = new poll_result{dir, std::nullopt, std::nullopt};
+
+            struct ::statx stat;
+            const auto stat_result = ::statx(AT_FDCWD,
+                                             path.c_str(),
+                                             AT_NO_AUTOMOUNT,
+                                             STATX_MTIME | STATX_CTIME,
+                                             &stat);
+            if (stat_result == 0)
+            {
+                result->stamp = {stat.stx_mtime, stat.stx_ctime};
+
+                if (!last || !is_same_timestamp(last->first, stat.stx_mtime) ||
+                    !is_same_timestamp(last->second, stat.stx_ctime))
+                {
+                    vfs::linux::dirent::scanner scanner(path);
+                    if (scanner.is_open())
+                    {
+                        std::vector<std::string> names;
+                        for (auto& entry : scanner.read_all())
+                        {
+                            names.push_back(std::move(entry.name));
+                        }
+                        result->names = std::move(names);
+                    }
+                }
+            }
+
+            g_idle_add_full(G_PRIORITY_LOW, (GSourceFunc)on_poll_result, result, nullptr);
+        });
+
+    this->schedule_poll(poll_timeout);
+}
+
+void
+vfs::dir::apply_poll(const poll_result& result) noexcept
+{
+    this->poll_running_ = false;
+    if (this->poll_stalled_)
+    {
+        this->poll_stalled_ = false;
+
+        const auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::steady_clock::now() - this->poll_started_);
+        ztd::logger::info("Change polling for {} returned after {}s",
+                          this->path_.string(),
+                          elapsed.count());
+    }
+
+    if (this->shutdown_ || !this->is_polled())
+    {
+        this->cancel_poll();
+        return;
+    }
+
+    // like diff_snapshot(), new and vanished names are both queued as created,
+    // update_created_files() sorts them out
+    u64 changes = 0;
+    if (result.names)
+    {
+        const auto& names = result.names.value();
+
+        std::unordered_set<std::string_view> listed;
+        listed.reserve(names.size());
+        for (const auto& name : names)
+        {
+            listed.insert(name);
+            if (!this->contains(name) && !this->is_file_user_hidden(name))
+            {
+                this->emit_file_created(this->path_ / name, true);
+                changes += 1;
+            }
+        }
+
+        const auto files = [this]
+        {
+            const std::scoped_lock<std::mutex> files_lock(this->files_lock_);
+            return this->files_;
+        }();
+        for (const auto& file : files)
+        {
+            if (!listed.contains(file->name()))
+            {
+                this->emit_file_created(file->path(), true);
+                changes += 1;
+            }
+        }
+
+        // only once the names have been compared, a failed read is retried
+        this->poll_stamp_ = result.stamp;
+    }
+
+    // check again soon after a change, back off while nothing changes
+    this->poll_delay_ = changes != 0 ? this->poll_interval_
+                                     : std::min(this->poll_delay_ * 2, this->poll_interval_ * 8);
+    this->schedule_poll(this->poll_delay_);
 }
 
 void
@@ -200,6 +544,47 @@ vfs::dir::is_file_user_hidden(const std::filesystem::path& path) const noexcept
     return false;
 }
 
+u32
+vfs::dir::load_threads() const noexcept
+{
+    const auto threads = this->avoid_changes_ ? config::settings.dir_load_threads_network
+                                              : config::settings.dir_load_threads;
+    if (threads == 0)
+    {
+        return std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    return threads;
+}
+
+// smallest directory that gets a snapshot, unless it is on a network filesystem
+static constexpr usize snapshot_min_files{1000};
+
+// number of entries a worker resolves per task
+static constexpr usize load_shard_size{256};
+
+static std::shared_ptr<vfs::file>
+create_file(const vfs::linux::dirent::scanner& scanner, const std::filesystem::path& path,
+            vfs::linux::dirent::entry& entry) noexcept
+{
+    struct ::statx stat{};
+    if (!scanner.stat(entry, stat))
+    {
+        if (errno == ENOENT)
+        { // file was deleted after being listed
+            return nullptr;
+        }
+
+        // still list files that can not be stat'ed, such as the contents of a
+        // directory without search permission, using the type from d_type.
+        const vfs::file::stat_data unknown{.mode = static_cast<u16>(DTTOIF(entry.type))};
+        return vfs::file::create(
+            path / entry.name,
+            unknown,
+            vfs::mime_type::create_from_type(vfs::constants::mime_type::unknown));
+    }
+    return vfs::file::create(path / entry.name, stat);
+}
+
 concurrencpp::result<bool>
 vfs::dir::load_thread() noexcept
 {
@@ -213,32 +598,381 @@ vfs::dir::load_thread() noexcept
     // load this dirs .hidden file
     this->load_user_hidden_files();
 
-    const std::scoped_lock<std::mutex> files_lock(this->files_lock_);
+    const auto is_user_hidden = [this](const auto& entry)
+    {
+        if (this->is_file_user_hidden(entry.name))
+        {
+            this->xhidden_count_++;
+            return true;
+        }
+        return false;
+    };
+
+    // 0 disables virtual dirs
+    const usize virtual_min_files = config::settings.dir_virtual_min_files;
+
+    // list the saved snapshot right away, the directory is
+    // still read below and only the differences are signaled
+    struct ::statx dir_stat{};
+    const bool use_snapshot = config::settings.dir_snapshots &&
+                              ::statx(AT_FDCWD,
+                                      this->path_.c_str(),
+                                      AT_NO_AUTOMOUNT,
+                                      vfs::linux::dirent::statx_mask,
+                                      &dir_stat) == 0;
+    std::optional<std::vector<vfs::dir_snapshot::entry>> snapshot{std::nullopt};
+    if (use_snapshot)
+    {
+        snapshot = vfs::dir_snapshot::load(this->path_, dir_stat);
+        if (snapshot && virtual_min_files != 0 && snapshot->size() >= virtual_min_files)
+        { // grew past the limit since it was saved, the names are read below
+            snapshot = std::nullopt;
+        }
+        if (snapshot)
+        {
+            std::vector<std::shared_ptr<vfs::file>> files;
+            files.reserve(snapshot->size());
+            for (const auto& entry : snapshot.value())
+            {
+                if (this->is_file_user_hidden(entry.name))
+                {
+                    continue;
+                }
+                files.push_back(vfs::file::create(this->path_ / entry.name,
+                                                  entry.stat,
+                                                  vfs::mime_type::create_from_type(entry.mime_type)));
+            }
+            this->queue_listed_files(std::move(files), true);
+        }
+    }
+    // every file read, used to check and save the snapshot
+    std::vector<std::shared_ptr<vfs::file>> scanned;
 
-    for (const auto& dfile : std::filesystem::directory_iterator(this->path_))
+    // files are handed to the main loop in batches so that the first
+    // entries can be shown while the rest of the directory is still being read
+    static constexpr usize batch_size{2000};
+    static constexpr std::chrono::milliseconds batch_interval{50};
+
+    std::vector<std::shared_ptr<vfs::file>> batch;
+    batch.reserve(batch_size);
+    auto batch_start = std::chrono::steady_clock::now();
+
+    const auto add_to_batch = [this, &batch, &batch_start, &scanned, &snapshot, use_snapshot](
+                                  std::shared_ptr<vfs::file>&& file)
     {
-        if (this->shutdown_)
+        if (use_snapshot)
+        {
+            scanned.push_back(file);
+        }
+
+        if (snapshot)
+        { // already listed from the snapshot
+            return;
+        }
+
+        batch.push_back(std::move(file));
+
+        const auto now = std::chrono::steady_clock::now();
+        if (batch.size() >= batch_size || now - batch_start >= batch_interval)
+        {
+            this->queue_listed_files(std::move(batch), false);
+
+            batch = {};
+            batch.reserve(batch_size);
+            batch_start = now;
+        }
+    };
+
+    const auto threads = this->load_threads();
+    const auto pool = global::runtime.thread_pool_executor();
+
+    vfs::linux::dirent::scanner scanner(this->path_);
+
+    // files are streamed while the entries are counted. once a directory turns out to be
+    // this large the files queued so far are dropped and it is read again by name only.
+    const bool count_entries = !snapshot && virtual_min_files != 0;
+    usize entry_count = 0;
+
+    while (true)
+    {
+        auto entries = scanner.next();
+        if (entries.empty())
         {
+            break;
+        }
+
+        entry_count += entries.size();
+        if (count_entries && entry_count >= virtual_min_files && scanner.rewind())
+        {
+            this->xhidden_count_ = 0;
+
+            auto names = scanner.read_all();
+            std::erase_if(names, is_user_hidden);
+
+            ztd::logger::info("Listing {} by name only, {} entries",
+                              this->path_.string(),
+                              names.size());
+
+            this->queue_listed_entries(std::move(names));
+
             co_return true;
         }
 
-        if (this->is_file_user_hidden(dfile.path()))
+        std::erase_if(entries, is_user_hidden);
+
+        if (threads <= 1 || entries.size() <= load_shard_size)
         {
-            this->xhidden_count_++;
+            for (auto& entry : entries)
+            {
+                if (this->shutdown_)
+                {
+                    co_return true;
+                }
+
+                auto file = create_file(scanner, this->path_, entry);
+                if (file)
+                {
+                    add_to_batch(std::move(file));
+                }
+            }
             continue;
         }
 
-        this->files_.push_back(vfs::file::create(dfile.path()));
+        // split the entries into shards, at most one shard per worker is in flight.
+        // shards are collected in submission order so files keep their directory order.
+        const std::span<vfs::linux::dirent::entry> all_entries = entries;
+        for (usize offset = 0; offset < all_entries.size(); offset += load_shard_size * threads)
+        {
+            if (this->shutdown_)
+            {
+                co_return true;
+            }
+
+            std::vector<concurrencpp::result<std::vector<std::shared_ptr<vfs::file>>>> shards;
+            for (usize shard = 0; shard < threads; ++shard)
+            {
+                const auto begin = offset + (shard * load_shard_size);
+                if (begin >= all_entries.size())
+                {
+                    break;
+                }
+                const auto count = std::min(load_shard_size, all_entries.size() - begin);
+
+                shards.push_back(pool->submit(
+                    [this, &scanner, shard_entries = all_entries.subspan(begin, count)]
+                    {
+                        std::vector<std::shared_ptr<vfs::file>> files;
+                        files.reserve(shard_entries.size());
+                        for (auto& entry : shard_entries)
+                        {
+                            auto file = create_file(scanner, this->path_, entry);
+                            if (file)
+                            {
+                                files.push_back(std::move(file));
+                            }
+                        }
+                        return files;
+                    }));
+            }
+
+            // block instead of co_await so the rest of the load stays on this dirs thread
+            for (auto& shard : shards)
+            {
+                for (auto& file : shard.get())
+                {
+                    add_to_batch(std::move(file));
+                }
+            }
+        }
     }
 
-    this->run_event<spacefm::signal::file_listed>();
+    if (snapshot)
+    {
+        this->diff_snapshot(snapshot.value(), scanned);
+    }
+    else
+    {
+        this->queue_listed_files(std::move(batch), true);
+    }
 
-    this->load_complete_ = true;
-    this->load_complete_initial_ = true;
+    if (use_snapshot && (snapshot || this->avoid_changes_ || scanned.size() >= snapshot_min_files))
+    {
+        // once listed, the main loop updates these files while holding files_lock_
+        std::vector<vfs::dir_snapshot::entry> entries;
+        entries.reserve(scanned.size());
+        {
+            const std::scoped_lock<std::mutex> files_lock(this->files_lock_);
+            for (const auto& file : scanned)
+            {
+                entries.push_back({std::string(file->name()),
+                                   file->stat(),
+                                   std::string(file->mime_type()->type())});
+            }
+        }
+        vfs::dir_snapshot::save(this->path_, dir_stat, entries);
+    }
 
     co_return true;
 }
 
+static bool
+is_same_file_stat(const vfs::file::stat_data& a, const vfs::file::stat_data& b) noexcept
+{
+    const auto is_same_timestamp = [](const auto& x, const auto& y)
+    { return x.tv_sec == y.tv_sec && x.tv_nsec == y.tv_nsec; };
+
+    return a.mode == b.mode && a.uid == b.uid && a.gid == b.gid && a.size == b.size &&
+           a.ino == b.ino && is_same_timestamp(a.mtime, b.mtime) &&
+           is_same_timestamp(a.ctime, b.ctime);
+}
+
+void
+vfs::dir::diff_snapshot(const std::span<const vfs::dir_snapshot::entry> snapshot,
+                        const std::span<const std::shared_ptr<vfs::file>> files) noexcept
+{
+    std::unordered_map<std::string_view, const vfs::file::stat_data*> saved;
+    saved.reserve(snapshot.size());
+    for (const auto& entry : snapshot)
+    {
+        if (!this->is_file_user_hidden(entry.name))
+        {
+            saved.insert({entry.name, &entry.stat});
+        }
+    }
+
+    // update_created_files() checks each queued name against files_ and
+    // the filesystem, so created, changed and deleted files are all queued as created.
+    u64 changes = 0;
+    for (const auto& file : files)
+    {
+        const auto it = saved.find(file->name());
+        if (it == saved.cend() || !is_same_file_stat(*it->second, file->stat()))
+        {
+            this->emit_file_created(file->path(), true);
+            changes += 1;
+        }
+        if (it != saved.cend())
+        {
+            saved.erase(it);
+        }
+    }
+
+    for (const auto& [name, stat] : saved)
+    { // deleted since the snapshot was saved
+        this->emit_file_created(this->path_ / name, true);
+        changes += 1;
+    }
+
+    ztd::logger::debug("Directory snapshot for {} had {} changes", this->path_.string(), changes);
+}
+
+static bool
+notify_file_listed(void* user_data) noexcept
+{
+    const auto dir = static_cast<vfs::dir*>(user_data)->shared_from_this();
+
+    dir->update_listed_files();
+
+    return false;
+}
+
+void
+vfs::dir::queue_listed_files(std::vector<std::shared_ptr<vfs::file>>&& files,
+                             const bool complete) noexcept
+{
+    const std::scoped_lock<std::mutex> listed_files_lock(this->listed_files_lock_);
+
+    if (!files.empty())
+    {
+        this->listed_files_.push_back(std::move(files));
+    }
+
+    if (complete)
+    {
+        this->listed_files_complete_ = true;
+    }
+
+    if (this->listed_notify_idle == 0)
+    {
+        this->listed_notify_idle = g_idle_add_full(G_PRIORITY_DEFAULT_IDLE,
+                                                   (GSourceFunc)::notify_file_listed,
+                                                   this,
+                                                   nullptr);
+    }
+}
+
+void
+vfs::dir::queue_listed_entries(std::vector<vfs::linux::dirent::entry>&& entries) noexcept
+{
+    const std::scoped_lock<std::mutex> listed_files_lock(this->listed_files_lock_);
+
+    // files streamed before the directory was known to be this large are replaced
+    this->listed_files_.clear();
+    this->listed_entries_ = std::move(entries);
+    this->listed_files_complete_ = true;
+
+    if (this->listed_notify_idle == 0)
+    {
+        this->listed_notify_idle = g_idle_add_full(G_PRIORITY_DEFAULT_IDLE,
+                                                   (GSourceFunc)::notify_file_listed,
+                                                   this,
+                                                   nullptr);
+    }
+}
+
+void
+vfs::dir::update_listed_files() noexcept
+{
+    std::vector<std::vector<std::shared_ptr<vfs::file>>> listed;
+    std::optional<std::vector<vfs::linux::dirent::entry>> entries{std::nullopt};
+    bool complete = false;
+    {
+        const std::scoped_lock<std::mutex> listed_files_lock(this->listed_files_lock_);
+
+        this->listed_notify_idle = 0;
+
+        std::swap(listed, this->listed_files_);
+        std::swap(entries, this->listed_entries_);
+        complete = this->listed_files_complete_;
+        this->listed_files_complete_ = false;
+    }
+
+    if (entries)
+    {
+        const std::scoped_lock<std::mutex> files_lock(this->files_lock_);
+
+        this->virtual_ = true;
+        this->entries_ = std::move(entries.value());
+        this->recent_files_index_.clear();
+        this->recent_files_.clear();
+        this->clear_files();
+    }
+
+    for (const auto& files : listed)
+    {
+        {
+            const std::scoped_lock<std::mutex> files_lock(this->files_lock_);
+
+            this->files_.reserve(this->files_.size() + files.size());
+            this->files_index_.reserve(this->files_index_.size() + files.size());
+            for (const auto& file : files)
+            {
+                this->add_file(file);
+            }
+        }
+
+        this->run_event<spacefm::signal::file_listed_batch>(files);
+    }
+
+    if (complete)
+    {
+        this->load_complete_ = true;
+        this->load_complete_initial_ = true;
+
+        this->run_event<spacefm::signal::file_listed>();
+    }
+}
+
 void
 vfs::dir::refresh() noexcept
 {
@@ -262,6 +996,28 @@ vfs::dir::refresh_thread() noexcept
     // reload this dirs .hidden file
     this->load_user_hidden_files();
 
+    if (this->virtual_)
+    {
+        vfs::linux::dirent::scanner scanner(this->path_);
+        auto entries = scanner.read_all();
+        std::erase_if(entries,
+                      [this](const auto& entry)
+                      {
+                          if (this->is_file_user_hidden(entry.name))
+                          {
+                              this->xhidden_count_++;
+                              return true;
+                          }
+                          return false;
+                      });
+
+        this->queue_listed_entries(std::move(entries));
+
+        this->running_refresh_ = false;
+
+        co_return true;
+    }
+
     for (const auto& dfile : std::filesystem::directory_iterator(this->path_))
     {
         if (this->shutdown_)
@@ -277,7 +1033,7 @@ vfs::dir::refresh_thread() noexcept
         }
 
         const auto filename = dfile.path().filename();
-        if (this->find_file(filename) == nullptr)
+        if (!this->contains(filename.native()))
         {
             this->emit_file_created(filename, false);
         }
@@ -319,11 +1075,113 @@ vfs::dir::refresh_thread() noexcept
     co_return true;
 }
 
+void
+vfs::dir::resync() noexcept
+{
+    if (this->virtual_ || this->avoid_changes_ || this->resync_queued_)
+    {
+        return;
+    }
+
+    // runs after any load or refresh in progress, they hold lock_
+    this->resync_queued_ = true;
+    this->executor_result_ = this->executor_->submit([this] { return this->resync_thread(); });
+}
+
+static bool
+is_same_file_statx(const vfs::file::stat_data& a, const struct ::statx& b) noexcept
+{
+    const auto is_same_timestamp = [](const auto& x, const auto& y)
+    { return x.tv_sec == y.tv_sec && x.tv_nsec == y.tv_nsec; };
+
+    return a.mode == b.stx_mode && a.uid == b.stx_uid && a.gid == b.stx_gid &&
+           a.size == b.stx_size && a.ino == b.stx_ino && is_same_timestamp(a.mtime, b.stx_mtime) &&
+           is_same_timestamp(a.ctime, b.stx_ctime);
+}
+
+concurrencpp::result<bool>
+vfs::dir::resync_thread() noexcept
+{
+    auto guard = co_await this->lock_.lock(this->executor_);
+
+    // events lost after this point queue another resync
+    this->resync_queued_ = false;
+
+    // the main loop updates and renames files while holding files_lock_,
+    // so names and stats are copied out under it instead of read later
+    auto known = [this]
+    {
+        const std::scoped_lock<std::mutex> files_lock(this->files_lock_);
+
+        std::unordered_map<std::string, vfs::file::stat_data> known;
+        known.reserve(this->files_.size());
+        for (const auto& file : this->files_)
+        {
+            known.insert({std::string(file->name()), file->stat()});
+        }
+        return known;
+    }();
+
+    vfs::linux::dirent::scanner scanner(this->path_);
+    if (!scanner.is_open())
+    {
+        co_return false;
+    }
+
+    // like diff_snapshot(), created, changed and deleted files are all queued as created,
+    // update_created_files() sorts them out. unchanged files are not touched.
+    u64 changes = 0;
+    for (auto& entry : scanner.read_all())
+    {
+        if (this->shutdown_)
+        {
+            co_return false;
+        }
+
+        if (this->is_file_user_hidden(entry.name))
+        {
+            continue;
+        }
+
+        const auto it = known.find(entry.name);
+        struct ::statx stat;
+        if (it == known.cend() || !scanner.stat(entry, stat) ||
+            !is_same_file_statx(it->second, stat))
+        {
+            this->emit_file_created(this->path_ / entry.name, true);
+            changes += 1;
+        }
+        if (it != known.cend())
+        {
+            known.erase(it);
+        }
+    }
+
+    for (const auto& name : known | std::views::keys)
+    { // deleted while events were lost
+        this->emit_file_created(this->path_ / name, true);
+        changes += 1;
+    }
+
+    ztd::logger::info("Resynced {} after lost monitor events, {} changes",
+                      this->path_.string(),
+                      changes);
+
+    co_return true;
+}
+
 /* Callback function which will be called when monitored events happen */
 void
-vfs::dir::on_monitor_event(const vfs::monitor::event event,
-                           const std::filesystem::path& path) noexcept
+vfs::dir::on_monitor_event(const vfs::monitor::event event, const std::filesystem::path& path,
+                           const std::filesystem::path& old_path) noexcept
 {
+    if (this->virtual_)
+    { // too many files to track, see is_virtual()
+        return;
+    }
+
+    this->record_monitor_event();
+
     switch (event)
     {
         case vfs::monitor::event::created:
@@ -335,11 +1193,70 @@ vfs::dir::on_monitor_event(const vfs::monitor::event event,
         case vfs::monitor::event::changed:
             this->emit_file_changed(path, false);
             break;
+        case vfs::monitor::event::renamed:
+            this->emit_file_renamed(old_path, path);
+            break;
+        case vfs::monitor::event::overflow:
+            this->resync();
+            break;
         case vfs::monitor::event::other:
             break;
     }
 }
 
+f64
+vfs::dir::decayed_event_rate(const std::chrono::steady_clock::time_point now) const noexcept
+{
+    // every event adds 1 and decays by e every second,
+    // a steady rate of n events per second settles at n
+    const std::chrono::duration<f64> elapsed = now - this->event_rate_time_;
+    return this->event_rate_ * std::exp(-elapsed.count());
+}
+
+f64
+vfs::dir::event_rate() const noexcept
+{
+    return this->decayed_event_rate(std::chrono::steady_clock::now());
+}
+
+bool
+vfs::dir::is_throttled() const noexcept
+{
+    return this->throttled_;
+}
+
+void
+vfs::dir::record_monitor_event() noexcept
+{
+    const auto now = std::chrono::steady_clock::now();
+    this->event_rate_ = this->decayed_event_rate(now) + 1.0;
+    this->event_rate_time_ = now;
+
+    this->update_throttled();
+}
+
+void
+vfs::dir::update_throttled() noexcept
+{
+    const auto hot_events = config::settings.dir_hot_events;
+    const auto rate = this->event_rate();
+
+    if (!this->throttled_ && hot_events != 0 && rate > hot_events)
+    {
+        this->throttled_ = true;
+
+        ztd::logger::info("Throttling changes in {}, {:.0f} events/s", this->path_.string(), rate);
+    }
+    else if (this->throttled_ && (hot_events == 0 || rate < hot_events / 2.0))
+    {
+        this->throttled_ = false;
+
+        ztd::logger::info("Stopped throttling changes in {}, {:.0f} events/s",
+                          this->path_.string(),
+                          rate);
+    }
+}
+
 void
 vfs::dir::global_unload_thumbnails(const vfs::file::thumbnail_size size) noexcept
 {
@@ -352,11 +1269,10 @@ vfs::dir::find_file(const std::filesystem::path& filename) noexcept
 {
     const std::scoped_lock<std::mutex> files_lock(this->files_lock_);
 
-    const auto action = [&filename](const auto& file) { return file->name() == filename.string(); };
-    const auto it = std::ranges::find_if(this->files_, action);
-    if (it != this->files_.cend())
+    const auto it = this->files_index_.find(filename.native());
+    if (it != this->files_index_.cend())
     {
-        return *it;
+        return it->second;
     }
     return nullptr;
 }
@@ -402,27 +1318,55 @@ vfs::dir::is_loaded() const noexcept
 bool
 vfs::dir::is_directory_empty() const noexcept
 {
-    return this->files_.empty();
+    return this->files_.empty() && this->entries_.empty();
+}
+
+u64
+vfs::dir::memory_usage() noexcept
+{
+    const std::scoped_lock<std::mutex> files_lock(this->files_lock_);
+
+    u64 memory = sizeof(vfs::dir);
+    for (const auto& file : this->files_)
+    {
+        memory += file->memory_usage();
+    }
+    for (const auto& file : this->recent_files_)
+    {
+        memory += file->memory_usage();
+    }
+    for (const auto& entry : this->entries_)
+    {
+        memory += sizeof(entry) + entry.name.capacity();
+    }
+    return memory;
+}
+
+bool
+vfs::dir::change_set::empty() const noexcept
+{
+    return this->created.empty() && this->changed.empty() && this->deleted.empty() &&
+           this->renamed.empty();
 }
 
 bool
-vfs::dir::update_file_info(const std::shared_ptr<vfs::file>& file) noexcept
+vfs::dir::update_file_info(const std::shared_ptr<vfs::file>& file, change_set& changes) noexcept
 {
-    const bool file_updated = file->update();
+    bool file_updated = false;
+    {
+        // resync_thread() copies the stat of every file under this lock
+        const std::scoped_lock<std::mutex> files_lock(this->files_lock_);
+        file_updated = file->update();
+    }
     if (!file_updated)
     { /* The file does not exist */
-        if (std::ranges::contains(this->files_, file))
+        if (this->find_file(file->name()) == file)
         {
-            const std::scoped_lock<std::mutex> files_lock(this->files_lock_);
-            // TODO - FIXME - using std::ranges::remove here will
-            // caues a segfault when deleting/moving/loading thumbails
-            // std::ranges::remove(this->files_, file);
-            this->files_.erase(std::remove(this->files_.begin(), this->files_.end(), file),
-                               this->files_.end());
-            if (file)
             {
-                this->run_event<spacefm::signal::file_deleted>(file);
+                const std::scoped_lock<std::mutex> files_lock(this->files_lock_);
+                this->remove_file(file);
             }
+            changes.deleted.push_back(file);
         }
     }
     return file_updated;
@@ -433,8 +1377,18 @@ notify_file_change(void* user_data) noexcept
 {
     const auto dir = static_cast<vfs::dir*>(user_data)->shared_from_this();
 
-    dir->update_changed_files();
-    dir->update_created_files();
+    if (dir->is_loading())
+    { // keep the events queued until the directory has been fully read
+        return true;
+    }
+
+    vfs::dir::change_set changes;
+    dir->update_changed_files(changes);
+    dir->update_created_files(changes);
+    dir->emit_changes(changes);
+
+    // events may have stopped, the rate is otherwise only checked on the next event
+    dir->update_throttled();
 
     /* remove the timeout */
     dir->change_notify_timeout = 0;
@@ -446,8 +1400,14 @@ vfs::dir::notify_file_change(const std::chrono::milliseconds timeout) noexcept
 {
     if (this->change_notify_timeout == 0)
     {
+        // hot directories collapse every change in the interval into one update
+        const auto interval =
+            this->throttled_
+                ? std::max(timeout, std::chrono::milliseconds(config::settings.dir_hot_interval))
+                : timeout;
+
         this->change_notify_timeout = g_timeout_add_full(G_PRIORITY_LOW,
-                                                         timeout.count(),
+                                                         interval.count(),
                                                          (GSourceFunc)::notify_file_change,
                                                          this,
                                                          nullptr);
@@ -455,7 +1415,7 @@ vfs::dir::notify_file_change(const std::chrono::milliseconds timeout) noexcept
 }
 
 void
-vfs::dir::update_changed_files() noexcept
+vfs::dir::update_changed_files(change_set& changes) noexcept
 {
     const std::scoped_lock<std::mutex> changed_files_lock(this->changed_files_lock_);
 
@@ -466,17 +1426,17 @@ vfs::dir::update_changed_files() noexcept
 
     for (const auto& file : this->changed_files_)
     {
-        if (this->update_file_info(file))
+        if (this->update_file_info(file, changes))
         {
-            this->run_event<spacefm::signal::file_changed>(file);
+            changes.changed.push_back(file);
         }
-        // else was deleted, signaled, and unrefed in update_file_info
+        // else was deleted, added to changes.deleted in update_file_info
     }
     this->changed_files_.clear();
 }
 
 void
-vfs::dir::update_created_files() noexcept
+vfs::dir::update_created_files(change_set& changes) noexcept
 {
     const std::scoped_lock<std::mutex> created_files_lock(this->created_files_lock_);
 
@@ -503,25 +1463,49 @@ vfs::dir::update_created_files() noexcept
                 const std::scoped_lock<std::mutex> files_lock(this->files_lock_);
 
                 const auto file = vfs::file::create(full_path);
-                this->files_.push_back(file);
+                this->add_file(file);
 
-                this->run_event<spacefm::signal::file_created>(file);
+                changes.created.push_back(file);
             }
             // else file does not exist in filesystem
         }
         else
         {
             // file already exists in dir this->files_
-            if (this->update_file_info(file_found))
+            if (this->update_file_info(file_found, changes))
             {
-                this->run_event<spacefm::signal::file_changed>(file_found);
+                changes.changed.push_back(file_found);
             }
-            // else was deleted, signaled, and unrefed in update_file_info
+            // else was deleted, added to changes.deleted in update_file_info
         }
     }
     this->created_files_.clear();
 }
 
+void
+vfs::dir::emit_changes(change_set& changes) noexcept
+{
+    // a file can be queued as both changed and created,
+    // or change and then be deleted in the same interval.
+    const auto by_pointer = [](const auto& file) { return file.get(); };
+    std::ranges::sort(changes.changed, std::less{}, by_pointer);
+    const auto [first, last] = std::ranges::unique(changes.changed, std::equal_to{}, by_pointer);
+    changes.changed.erase(first, last);
+    std::erase_if(changes.changed,
+                  [&changes](const auto& file)
+                  { return std::ranges::contains(changes.deleted, file); });
+    std::erase_if(changes.renamed,
+                  [&changes](const auto& renamed)
+                  { return std::ranges::contains(changes.deleted, renamed.file); });
+
+    if (changes.empty())
+    {
+        return;
+    }
+
+    this->run_event<spacefm::signal::file_changes>(changes);
+}
+
 void
 vfs::dir::unload_thumbnails(const vfs::file::thumbnail_size size) noexcept
 {
@@ -531,6 +1515,10 @@ vfs::dir::unload_thumbnails(const vfs::file::thumbnail_size size) noexcept
     {
         file->unload_thumbnail(size);
     }
+    for (const auto& file : this->recent_files_)
+    {
+        file->unload_thumbnail(size);
+    }
 
     /* Ensuring free space at the end of the heap is freed to the OS,
      * mainly to deal with the possibility thousands of large thumbnails
@@ -579,7 +1567,7 @@ vfs::dir::emit_file_deleted(const std::filesystem::path& path) noexcept
         const std::scoped_lock<std::mutex> files_lock(this->files_lock_);
 
         /* clear the whole list */
-        this->files_.clear();
+        this->clear_files();
 
         this->run_event<spacefm::signal::file_deleted>(nullptr);
 
@@ -629,24 +1617,79 @@ vfs::dir::emit_file_changed(const std::filesystem::path& path, bool force) noexc
 
         if (!std::ranges::contains(this->changed_files_, file_found))
         {
-            if (force)
-            {
+            if (force || this->throttled_)
+            { // hot directories do not update files on the first event, see is_throttled()
                 this->changed_files_.push_back(file_found);
 
                 this->notify_file_change(std::chrono::milliseconds(100));
             }
-            else if (this->update_file_info(file_found)) // update file info the first time
+            else
             {
-                this->changed_files_.push_back(file_found);
+                // update file info the first time
+                change_set changes;
+                if (this->update_file_info(file_found, changes))
+                {
+                    this->changed_files_.push_back(file_found);
 
-                this->notify_file_change(std::chrono::milliseconds(500));
+                    this->notify_file_change(std::chrono::milliseconds(500));
 
-                this->run_event<spacefm::signal::file_changed>(file_found);
+                    changes.changed.push_back(file_found);
+                }
+                this->emit_changes(changes);
             }
         }
     }
 }
 
+void
+vfs::dir::emit_file_renamed(const std::filesystem::path& old_path,
+                            const std::filesystem::path& path) noexcept
+{
+    if (this->shutdown_)
+    {
+        return;
+    }
+
+    // while loading, the directory read can still list the new name, queued
+    // creates are checked against files_ once loaded so no duplicate is added
+    const auto file = this->is_loading() ? nullptr : this->find_file(old_path.filename());
+    if (!file || this->avoid_changes_ || this->is_file_user_hidden(path))
+    { // no file to keep, same as a delete and a create
+        this->emit_file_deleted(old_path);
+        this->emit_file_created(path, false);
+        return;
+    }
+
+    // the path of a vfs::file never changes, other threads read it without a lock.
+    // the new name gets a new vfs::file that keeps the loaded thumbnails.
+    const auto renamed = vfs::file::create_renamed(file, path);
+
+    change_set changes;
+    {
+        const std::scoped_lock<std::mutex> files_lock(this->files_lock_);
+
+        const auto replaced = this->files_index_.find(path.filename().native());
+        if (replaced != this->files_index_.cend())
+        { // renamed over an existing file
+            const auto overwritten = replaced->second;
+            this->remove_file(overwritten);
+            changes.deleted.push_back(overwritten);
+        }
+
+        this->remove_file(file);
+        if (renamed)
+        {
+            this->add_file(renamed);
+            changes.renamed.push_back({file, renamed});
+        }
+        else
+        { // no longer exists
+            changes.deleted.push_back(file);
+        }
+    }
+    this->emit_changes(changes);
+}
+
 void
 vfs::dir::emit_thumbnail_loaded(const std::shared_ptr<vfs::file>& file) noexcept
 {
@@ -655,10 +1698,20 @@ vfs::dir::emit_thumbnail_loaded(const std::shared_ptr<vfs::file>& file) noexcept
         return;
     }
 
-    const std::scoped_lock<std::mutex> files_lock(this->files_lock_);
+    if (this->virtual_)
+    {
+        const std::scoped_lock<std::mutex> files_lock(this->files_lock_);
 
-    if (std::ranges::contains(this->files_, file))
+        const auto it = this->recent_files_index_.find(file->name());
+        if (it == this->recent_files_index_.cend() || *it->second != file)
+        {
+            return;
+        }
+    }
+    else if (this->find_file(file->name()) != file)
     {
-        this->run_event<spacefm::signal::file_thumbnail_loaded>(file);
+        return;
     }
+
+    this->run_event<spacefm::signal::file_thumbnail_loaded>(file);
 }
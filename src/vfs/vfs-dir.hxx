@@ -17,14 +17,28 @@
 
 #pragma once
 
+#include <string>
+#include <string_view>
+
 #include <filesystem>
 
+#include <span>
+
 #include <vector>
+#include <unordered_map>
+
+#include <list>
 
 #include <mutex>
 
+#include <functional>
+
 #include <memory>
 
+#include <optional>
+
+#include <utility>
+
 #include <chrono>
 
 #include <glibmm.h>
@@ -34,10 +48,13 @@
 
 #include "concurrency.hxx"
 
+#include "vfs/vfs-dir-snapshot.hxx"
 #include "vfs/vfs-file.hxx"
 #include "vfs/vfs-monitor.hxx"
 #include "vfs/vfs-thumbnailer.hxx"
 
+#include "vfs/linux/dirent.hxx"
+
 #include "signals.hxx"
 
 namespace vfs
@@ -55,19 +72,65 @@ struct dir : public std::enable_shared_from_this<dir>
     [[nodiscard]] static const std::shared_ptr<vfs::dir>
     create(const std::filesystem::path& path) noexcept;
 
+    // files created, changed, deleted and renamed since the last change notification,
+    // sent to listeners as a single file_changes signal.
+    struct change_set
+    {
+        std::vector<std::shared_ptr<vfs::file>> created;
+        std::vector<std::shared_ptr<vfs::file>> changed;
+        std::vector<std::shared_ptr<vfs::file>> deleted;
+        struct renamed_file
+        {
+            std::shared_ptr<vfs::file> old_file; // removed from the dir
+            std::shared_ptr<vfs::file> file;     // see vfs::file::create_renamed()
+        };
+        std::vector<renamed_file> renamed;
+
+        [[nodiscard]] bool empty() const noexcept;
+    };
+
     // unloads thumbnails in every vfs::dir
     static void global_unload_thumbnails(const vfs::file::thumbnail_size size) noexcept;
 
     [[nodiscard]] const std::filesystem::path& path() const noexcept;
     [[nodiscard]] const std::span<const std::shared_ptr<vfs::file>> files() const noexcept;
+    // is a file with this filename in files()
+    [[nodiscard]] bool contains(const std::string_view filename) noexcept;
+
+    // directories with at least config::settings.dir_virtual_min_files entries
+    // are only listed by name. files() stays empty, use entries() and materialize().
+    // file events are not tracked, refresh() rereads the names.
+    [[nodiscard]] bool is_virtual() const noexcept;
+    // every entry of a virtual dir, in directory order
+    [[nodiscard]] const std::span<const vfs::linux::dirent::entry> entries() const noexcept;
+    // the vfs::file for an entry of a virtual dir, nullptr if it no longer exists.
+    // the most recently used files are kept, older ones are dropped.
+    [[nodiscard]] const std::shared_ptr<vfs::file>
+    materialize(const std::string_view filename) noexcept;
 
     void refresh() noexcept;
+    // compare the files with the directory on disk and queue the differences,
+    // used when monitor events have been lost
+    void resync() noexcept;
 
     [[nodiscard]] u64 hidden_files() const noexcept;
 
     [[nodiscard]] bool avoid_changes() const noexcept;
+    // also starts or stops polling, see is_polled()
     void update_avoid_changes() noexcept;
 
+    // a dir that avoids changes is not monitored, instead its mtime and ctime are checked
+    // on a background thread every vfs::volume_dir_poll_interval(), and the names are read
+    // again when they changed. the interval grows while nothing changes.
+    [[nodiscard]] bool is_polled() const noexcept;
+
+    // monitor events per second, averaged over about the last second
+    [[nodiscard]] f64 event_rate() const noexcept;
+    // receiving more than config::settings.dir_hot_events monitor events per second,
+    // changes are applied every config::settings.dir_hot_interval instead of on each event.
+    // stops once the rate has dropped below half of dir_hot_events.
+    [[nodiscard]] bool is_throttled() const noexcept;
+
     // The dir has finished loading
     [[nodiscard]] bool is_loaded() const noexcept;
     // The dir is still loading
@@ -75,6 +138,9 @@ struct dir : public std::enable_shared_from_this<dir>
 
     [[nodiscard]] bool is_directory_empty() const noexcept;
 
+    // approximate memory used by the files in this dir, including thumbnails
+    [[nodiscard]] u64 memory_usage() noexcept;
+
     [[nodiscard]] bool add_hidden(const std::shared_ptr<vfs::file>& file) const noexcept;
 
     void load_thumbnail(const std::shared_ptr<vfs::file>& file,
@@ -86,12 +152,35 @@ struct dir : public std::enable_shared_from_this<dir>
     void emit_file_created(const std::filesystem::path& path, bool force) noexcept;
     void emit_file_deleted(const std::filesystem::path& path) noexcept;
     void emit_file_changed(const std::filesystem::path& path, bool force) noexcept;
+    void emit_file_renamed(const std::filesystem::path& old_path,
+                           const std::filesystem::path& path) noexcept;
     void emit_thumbnail_loaded(const std::shared_ptr<vfs::file>& file) noexcept;
 
     // TODO private
-    void update_created_files() noexcept;
-    void update_changed_files() noexcept;
+    void update_created_files(change_set& changes) noexcept;
+    void update_changed_files(change_set& changes) noexcept;
+    // send the file_changes signal, if anything changed
+    void emit_changes(change_set& changes) noexcept;
+    // leave or enter is_throttled() for the current event rate
+    void update_throttled() noexcept;
+    void update_listed_files() noexcept;
     u32 change_notify_timeout{0};
+    u32 listed_notify_idle{0};
+
+    // polling, see is_polled()
+    struct poll_result
+    {
+        std::weak_ptr<vfs::dir> dir;
+        // dir mtime and ctime, std::nullopt if the statx() failed
+        std::optional<std::pair<struct ::statx_timestamp, struct ::statx_timestamp>> stamp;
+        // only read if the stamp changed since the last check
+        std::optional<std::vector<std::string>> names;
+    };
+    // start a check on the background executor, unless one is still running
+    void poll() noexcept;
+    // apply a finished check on the main loop and schedule the next one
+    void apply_poll(const poll_result& result) noexcept;
+    u32 poll_timer{0};
 
   private:
     // this function is to be called right after a vfs::dir is created in ::create().
@@ -99,40 +188,115 @@ struct dir : public std::enable_shared_from_this<dir>
     void post_initialize() noexcept;
 
     concurrencpp::result<bool> load_thread() noexcept;
+    // number of workers used to create vfs::file objects, lower for network filesystems
+    [[nodiscard]] u32 load_threads() const noexcept;
     concurrencpp::result<bool> refresh_thread() noexcept;
+    concurrencpp::result<bool> resync_thread() noexcept;
 
-    void on_monitor_event(const vfs::monitor::event event,
-                          const std::filesystem::path& path) noexcept;
+    void on_monitor_event(const vfs::monitor::event event, const std::filesystem::path& path,
+                          const std::filesystem::path& old_path) noexcept;
 
     void notify_file_change(const std::chrono::milliseconds timeout) noexcept;
 
+    // start the next check after delay, see is_polled()
+    void schedule_poll(const std::chrono::seconds delay) noexcept;
+    void cancel_poll() noexcept;
+
+    // count a monitor event towards event_rate() and update is_throttled()
+    void record_monitor_event() noexcept;
+    [[nodiscard]] f64
+    decayed_event_rate(const std::chrono::steady_clock::time_point now) const noexcept;
+
+    // signal the differences between a snapshot and the files read from disk
+    void diff_snapshot(const std::span<const vfs::dir_snapshot::entry> snapshot,
+                       const std::span<const std::shared_ptr<vfs::file>> files) noexcept;
+
+    // queue files read by load_thread() to be added on the main loop
+    void queue_listed_files(std::vector<std::shared_ptr<vfs::file>>&& files,
+                            const bool complete) noexcept;
+    // queue the entries of a virtual dir, replaces entries_ on the main loop
+    void queue_listed_entries(std::vector<vfs::linux::dirent::entry>&& entries) noexcept;
+
     [[nodiscard]] const std::shared_ptr<vfs::file>
     find_file(const std::filesystem::path& filename) noexcept;
-    [[nodiscard]] bool update_file_info(const std::shared_ptr<vfs::file>& file) noexcept;
+    // returns false, and adds the file to changes.deleted, if the file no longer exists
+    [[nodiscard]] bool update_file_info(const std::shared_ptr<vfs::file>& file,
+                                        change_set& changes) noexcept;
 
     // dir .hidden file
     void load_user_hidden_files() noexcept;
     [[nodiscard]] bool is_file_user_hidden(const std::filesystem::path& path) const noexcept;
     std::optional<std::vector<std::filesystem::path>> user_hidden_files_{std::nullopt};
 
+    // files_ and files_index_ must only be modified together, with files_lock_ held
+    void add_file(const std::shared_ptr<vfs::file>& file) noexcept;
+    void remove_file(const std::shared_ptr<vfs::file>& file) noexcept;
+    void clear_files() noexcept;
+
     std::filesystem::path path_;
     std::vector<std::shared_ptr<vfs::file>> files_;
 
+    struct filename_hash
+    {
+        using is_transparent = void;
+
+        [[nodiscard]] usize
+        operator()(const std::string_view filename) const noexcept
+        {
+            return std::hash<std::string_view>{}(filename);
+        }
+    };
+    // filename lookup for files_
+    std::unordered_map<std::string, std::shared_ptr<vfs::file>, filename_hash, std::equal_to<>>
+        files_index_;
+
     vfs::thumbnailer thumbnailer_{
         std::bind(&vfs::dir::emit_thumbnail_loaded, this, std::placeholders::_1)};
     const vfs::monitor monitor_{
         this->path_,
-        std::bind(&vfs::dir::on_monitor_event, this, std::placeholders::_1, std::placeholders::_2)};
+        std::bind(&vfs::dir::on_monitor_event,
+                  this,
+                  std::placeholders::_1,
+                  std::placeholders::_2,
+                  std::placeholders::_3)};
 
     std::vector<std::shared_ptr<vfs::file>> changed_files_;
     std::vector<std::filesystem::path> created_files_;
 
+    // files read by load_thread() that have not been added to files_ yet
+    std::vector<std::vector<std::shared_ptr<vfs::file>>> listed_files_;
+    bool listed_files_complete_{false};
+    std::optional<std::vector<vfs::linux::dirent::entry>> listed_entries_{std::nullopt};
+
+    // virtual dir, see is_virtual()
+    bool virtual_{false};
+    std::vector<vfs::linux::dirent::entry> entries_;
+    // materialized files, most recently used first, guarded by files_lock_
+    std::list<std::shared_ptr<vfs::file>> recent_files_;
+    std::unordered_map<std::string_view, std::list<std::shared_ptr<vfs::file>>::iterator>
+        recent_files_index_;
+
     bool avoid_changes_{true}; // disable file events, for nfs mount locations.
 
+    // see event_rate() and is_throttled(), only used on the main loop
+    f64 event_rate_{0.0};
+    std::chrono::steady_clock::time_point event_rate_time_;
+    bool throttled_{false};
+
+    // see is_polled(), only used on the main loop
+    std::chrono::seconds poll_interval_{0}; // 0 if not polled
+    std::chrono::seconds poll_delay_{0};    // grows up to 8 times poll_interval_
+    bool poll_running_{false};
+    bool poll_stalled_{false}; // the running check exceeded the timeout, already logged
+    std::chrono::steady_clock::time_point poll_started_;
+    std::optional<std::pair<struct ::statx_timestamp, struct ::statx_timestamp>> poll_stamp_{
+        std::nullopt};
+
     bool load_complete_{false};         // is dir loaded, initial load or refresh
     bool load_complete_initial_{false}; // is dir loaded, initial load only, blocks refresh
 
     bool running_refresh_{false}; // is a refresh currently being run.
+    bool resync_queued_{false};   // a resync has been submitted but not started yet
 
     bool enable_thumbnails_{true};
 
@@ -143,6 +307,7 @@ struct dir : public std::enable_shared_from_this<dir>
     std::mutex files_lock_;
     std::mutex changed_files_lock_;
     std::mutex created_files_lock_;
+    std::mutex listed_files_lock_;
 
     // Concurrency
     std::shared_ptr<concurrencpp::thread_executor> executor_;
@@ -154,13 +319,14 @@ struct dir : public std::enable_shared_from_this<dir>
     // Signals Add Event
 
     template<spacefm::signal evt, typename bind_fun>
-    typename std::enable_if_t<evt == spacefm::signal::file_created, sigc::connection>
+    typename std::enable_if_t<evt == spacefm::signal::file_changes, sigc::connection>
     add_event(bind_fun fun) noexcept
     {
-        // ztd::logger::trace("Signal Connect   : spacefm::signal::file_created");
-        return this->evt_file_created.connect(fun);
+        // ztd::logger::trace("Signal Connect   : spacefm::signal::file_changes");
+        return this->evt_file_changes.connect(fun);
     }
 
+    // only for the directory itself, with a nullptr file
     template<spacefm::signal evt, typename bind_fun>
     typename std::enable_if_t<evt == spacefm::signal::file_changed, sigc::connection>
     add_event(bind_fun fun) noexcept
@@ -169,6 +335,7 @@ struct dir : public std::enable_shared_from_this<dir>
         return this->evt_file_changed.connect(fun);
     }
 
+    // only for the directory itself, with a nullptr file
     template<spacefm::signal evt, typename bind_fun>
     typename std::enable_if_t<evt == spacefm::signal::file_deleted, sigc::connection>
     add_event(bind_fun fun) noexcept
@@ -185,6 +352,14 @@ struct dir : public std::enable_shared_from_this<dir>
         return this->evt_file_listed.connect(fun);
     }
 
+    template<spacefm::signal evt, typename bind_fun>
+    typename std::enable_if_t<evt == spacefm::signal::file_listed_batch, sigc::connection>
+    add_event(bind_fun fun) noexcept
+    {
+        // ztd::logger::trace("Signal Connect   : spacefm::signal::file_listed_batch");
+        return this->evt_file_listed_batch.connect(fun);
+    }
+
     template<spacefm::signal evt, typename bind_fun>
     typename std::enable_if_t<evt == spacefm::signal::file_thumbnail_loaded, sigc::connection>
     add_event(bind_fun fun) noexcept
@@ -195,11 +370,11 @@ struct dir : public std::enable_shared_from_this<dir>
 
     // Signals Run Event
     template<spacefm::signal evt>
-    typename std::enable_if_t<evt == spacefm::signal::file_created, void>
-    run_event(const std::shared_ptr<vfs::file>& file) const noexcept
+    typename std::enable_if_t<evt == spacefm::signal::file_changes, void>
+    run_event(const change_set& changes) const noexcept
     {
-        // ztd::logger::trace("Signal Execute   : spacefm::signal::file_created");
-        this->evt_file_created.emit(file);
+        // ztd::logger::trace("Signal Execute   : spacefm::signal::file_changes");
+        this->evt_file_changes.emit(changes);
     }
 
     template<spacefm::signal evt>
@@ -226,6 +401,14 @@ struct dir : public std::enable_shared_from_this<dir>
         this->evt_file_listed.emit();
     }
 
+    template<spacefm::signal evt>
+    typename std::enable_if_t<evt == spacefm::signal::file_listed_batch, void>
+    run_event(const std::span<const std::shared_ptr<vfs::file>> files) const noexcept
+    {
+        // ztd::logger::trace("Signal Execute   : spacefm::signal::file_listed_batch");
+        this->evt_file_listed_batch.emit(files);
+    }
+
     template<spacefm::signal evt>
     typename std::enable_if_t<evt == spacefm::signal::file_thumbnail_loaded, void>
     run_event(const std::shared_ptr<vfs::file>& file) const noexcept
@@ -236,10 +419,11 @@ struct dir : public std::enable_shared_from_this<dir>
 
   private:
     // Signal types
-    sigc::signal<void(const std::shared_ptr<vfs::file>&)> evt_file_created;
+    sigc::signal<void(const change_set&)> evt_file_changes;
     sigc::signal<void(const std::shared_ptr<vfs::file>&)> evt_file_changed;
     sigc::signal<void(const std::shared_ptr<vfs::file>&)> evt_file_deleted;
     sigc::signal<void()> evt_file_listed;
+    sigc::signal<void(const std::span<const std::shared_ptr<vfs::file>>)> evt_file_listed_batch;
     sigc::signal<void(const std::shared_ptr<vfs::file>&)> evt_file_thumbnail_loaded;
 
   public:
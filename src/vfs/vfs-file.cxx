@@ -24,8 +24,18 @@
 
 #include <memory>
 
+#include <chrono>
+
+#include <mutex>
+
+#include <functional>
+
 #include <system_error>
 
+#include <sys/stat.h>
+
+#include <fcntl.h>
+
 #include <glibmm.h>
 
 #include <ztd/ztd.hxx>
@@ -33,11 +43,15 @@
 
 #include "settings/settings.hxx"
 
+#include "utils/misc.hxx"
+
 #include "vfs/vfs-app-desktop.hxx"
+#include "vfs/vfs-id-names.hxx"
 #include "vfs/vfs-mime-type.hxx"
 #include "vfs/vfs-user-dirs.hxx"
 #include "vfs/thumbnails/thumbnails.hxx"
 #include "vfs/utils/vfs-utils.hxx"
+#include "vfs/linux/dirent.hxx"
 
 #if defined(HAVE_MEDIA)
 #include "vfs/media/metadata.hxx"
@@ -45,31 +59,91 @@
 
 #include "vfs/vfs-file.hxx"
 
+// display strings are only created the first time they are used, files
+// are shared between the main loop and the thumbnailer and directory loading threads.
+static std::mutex display_lock;
+
+[[nodiscard]] static vfs::file::stat_data
+stat_data_from_statx(const struct ::statx& stat) noexcept
+{
+    vfs::file::stat_data data;
+    data.size = stat.stx_size;
+    data.blocks = stat.stx_blocks;
+    data.ino = stat.stx_ino;
+    data.attributes = stat.stx_attributes;
+    data.atime = stat.stx_atime;
+    data.btime = stat.stx_btime;
+    data.ctime = stat.stx_ctime;
+    data.mtime = stat.stx_mtime;
+    data.uid = stat.stx_uid;
+    data.gid = stat.stx_gid;
+    data.mode = stat.stx_mode;
+    return data;
+}
+
 const std::shared_ptr<vfs::file>
 vfs::file::create(const std::filesystem::path& path) noexcept
 {
     return std::make_shared<vfs::file>(path);
 }
 
-vfs::file::file(const std::filesystem::path& path) noexcept : path_(path)
+const std::shared_ptr<vfs::file>
+vfs::file::create(const std::filesystem::path& path, const struct ::statx& stat) noexcept
 {
-    // ztd::logger::debug("vfs::file::file({})    {}", ztd::logger::utils::ptr(this), this->path_);
-    this->uri_ = Glib::filename_to_uri(this->path_.string());
+    return std::make_shared<vfs::file>(path, stat);
+}
 
-    if (this->path_ == "/")
+const std::shared_ptr<vfs::file>
+vfs::file::create(const std::filesystem::path& path, const stat_data& stat,
+                  const std::shared_ptr<vfs::mime_type>& mime_type) noexcept
+{
+    return std::make_shared<vfs::file>(path, stat, mime_type);
+}
+
+const std::shared_ptr<vfs::file>
+vfs::file::create_renamed(const std::shared_ptr<vfs::file>& file,
+                          const std::filesystem::path& path) noexcept
+{
+    struct ::statx stat;
+    const auto result = ::statx(AT_FDCWD,
+                                path.c_str(),
+                                AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT,
+                                vfs::linux::dirent::statx_mask,
+                                &stat);
+    if (result == -1)
     {
-        // special case, using std::filesystem::path::filename() on the root
-        // directory returns an empty string. that causes subtle bugs
-        // so hard code "/" as the value for root.
-        this->name_ = "/";
+        return nullptr;
     }
-    else
+
+    // the mime type lookup uses this extension split, which keeps .tar.gz as one extension
+    const bool same_type = ::utils::split_basename_extension(file->path_).extension ==
+                               ::utils::split_basename_extension(path).extension &&
+                           !file->is_special_desktop_entry_ &&
+                           !path.filename().native().ends_with(".desktop");
+    if (!same_type)
     {
-        this->name_ = this->path_.filename();
+        return vfs::file::create(path, stat);
     }
 
-    // Is a hidden file
-    this->is_hidden_ = this->name_.starts_with('.');
+    const auto renamed = vfs::file::create(path, stat_data_from_statx(stat), file->mime_type_);
+
+    // same content and type, the loaded thumbnails still apply
+    if (file->big_thumbnail_)
+    {
+        renamed->big_thumbnail_ = g_object_ref(file->big_thumbnail_);
+    }
+    if (file->small_thumbnail_)
+    {
+        renamed->small_thumbnail_ = g_object_ref(file->small_thumbnail_);
+    }
+
+    return renamed;
+}
+
+vfs::file::file(const std::filesystem::path& path) noexcept : path_(path)
+{
+    // ztd::logger::debug("vfs::file::file({})    {}", ztd::logger::utils::ptr(this), this->path_);
+    this->init_name();
 
     const auto result = this->update();
     if (!result)
@@ -78,6 +152,23 @@ vfs::file::file(const std::filesystem::path& path) noexcept : path_(path)
     }
 }
 
+vfs::file::file(const std::filesystem::path& path, const struct ::statx& stat) noexcept
+    : file_stat_(stat_data_from_statx(stat)), path_(path)
+{
+    // ztd::logger::debug("vfs::file::file({})    {}", ztd::logger::utils::ptr(this), this->path_);
+    this->init_name();
+    this->update_info();
+}
+
+vfs::file::file(const std::filesystem::path& path, const stat_data& stat,
+                const std::shared_ptr<vfs::mime_type>& mime_type) noexcept
+    : file_stat_(stat), path_(path)
+{
+    // ztd::logger::debug("vfs::file::file({})    {}", ztd::logger::utils::ptr(this), this->path_);
+    this->init_name();
+    this->update_info(mime_type);
+}
+
 vfs::file::~file() noexcept
 {
     // ztd::logger::debug("vfs::file::~file({})   {}", ztd::logger::utils::ptr(this), this->path_);
@@ -91,55 +182,180 @@ vfs::file::~file() noexcept
     }
 }
 
+void
+vfs::file::init_name() noexcept
+{
+    if (this->path_ == "/")
+    {
+        // special case, using std::filesystem::path::filename() on the root
+        // directory returns an empty string. that causes subtle bugs
+        // so hard code "/" as the value for root.
+        this->name_ = this->path_.native();
+    }
+    else
+    {
+        // the filename is the end of the path, no need for a second copy
+        const std::string_view path = this->path_.native();
+        this->name_ = path.substr(path.size() - this->path_.filename().native().size());
+    }
+}
+
+[[nodiscard]] static std::filesystem::file_status
+file_status_from_mode(const u32 mode) noexcept
+{
+    std::filesystem::file_type type = std::filesystem::file_type::unknown;
+    switch (mode & S_IFMT)
+    {
+        case S_IFREG:
+            type = std::filesystem::file_type::regular;
+            break;
+        case S_IFDIR:
+            type = std::filesystem::file_type::directory;
+            break;
+        case S_IFLNK:
+            type = std::filesystem::file_type::symlink;
+            break;
+        case S_IFBLK:
+            type = std::filesystem::file_type::block;
+            break;
+        case S_IFCHR:
+            type = std::filesystem::file_type::character;
+            break;
+        case S_IFIFO:
+            type = std::filesystem::file_type::fifo;
+            break;
+        case S_IFSOCK:
+            type = std::filesystem::file_type::socket;
+            break;
+        default:
+            break;
+    }
+    return std::filesystem::file_status(type, std::filesystem::perms(mode & 07777));
+}
+
+[[nodiscard]] static std::chrono::system_clock::time_point
+time_point_from_statx(const struct ::statx_timestamp& ts) noexcept
+{
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec)));
+}
+
 bool
 vfs::file::update() noexcept
 {
-    std::error_code ec;
-    this->file_stat_ = ztd::statx(this->path_, ztd::statx::symlink::no_follow, ec);
-    if (ec)
+    struct ::statx stat;
+    const auto result = ::statx(AT_FDCWD,
+                                this->path_.c_str(),
+                                AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT,
+                                vfs::linux::dirent::statx_mask,
+                                &stat);
+    if (result == -1)
     {
         this->mime_type_ = vfs::mime_type::create_from_type(vfs::constants::mime_type::unknown);
         return false;
     }
+    this->file_stat_ = stat_data_from_statx(stat);
 
-    // ztd::logger::debug("vfs::file::update({})    {}  size={}", ztd::logger::utils::ptr(this), this->name, this->file_stat.size());
+    this->update_info();
 
-    // this->status = std::filesystem::status(file_path);
-    this->status_ = std::filesystem::symlink_status(this->path_);
+    return true;
+}
 
-    this->mime_type_ = vfs::mime_type::create_from_file(this->path_);
+u64
+vfs::file::memory_usage() const noexcept
+{
+    u64 memory = sizeof(vfs::file);
+
+    const std::scoped_lock<std::mutex> lock(display_lock);
+    for (const auto& str : {std::cref(this->path_.native()),
+                            std::cref(this->uri_),
+                            std::cref(this->display_size_),
+                            std::cref(this->display_size_bytes_),
+                            std::cref(this->display_disk_size_),
+                            std::cref(this->display_atime_),
+                            std::cref(this->display_btime_),
+                            std::cref(this->display_ctime_),
+                            std::cref(this->display_mtime_),
+                            std::cref(this->display_perm_)})
+    {
+        memory += str.get().capacity();
+    }
 
-    // file size formated
-    this->display_size_ = vfs::utils::format_file_size(this->size());
-    this->display_size_bytes_ = std::format("{:L}", this->size());
+    for (const auto* const thumbnail : {this->big_thumbnail_, this->small_thumbnail_})
+    {
+        if (thumbnail)
+        {
+            memory += gdk_pixbuf_get_byte_length(thumbnail);
+        }
+    }
 
-    // disk file size formated
-    this->display_disk_size_ = vfs::utils::format_file_size(this->size_on_disk());
+    return memory;
+}
 
-    // owner
-    const auto pw = ztd::passwd(this->file_stat_.uid());
-    this->display_owner_ = pw.name();
+void
+vfs::file::update_info(const std::shared_ptr<vfs::mime_type>& mime_type) noexcept
+{
+    // ztd::logger::debug("vfs::file::update_info({})    {}  size={}", ztd::logger::utils::ptr(this), this->name, this->size());
 
-    // group
-    const auto gr = ztd::group(this->file_stat_.gid());
-    this->display_group_ = gr.name();
+    this->target_size_ = 0;
+    this->target_mode_ = 0;
+    if (std::filesystem::is_symlink(this->status()))
+    {
+        // resolve the target once so the type checks do not need to hit the disk
+        struct ::statx target;
+        const auto result = ::statx(AT_FDCWD,
+                                    this->path_.c_str(),
+                                    AT_NO_AUTOMOUNT,
+                                    STATX_TYPE | STATX_SIZE,
+                                    &target);
+        if (result == 0)
+        {
+            this->target_size_ = target.stx_size;
+            this->target_mode_ = target.stx_mode;
+        }
+    }
 
-    // time
-    this->display_atime_ =
-        std::format("{}", std::chrono::floor<std::chrono::seconds>(this->atime()));
-    this->display_btime_ =
-        std::format("{}", std::chrono::floor<std::chrono::seconds>(this->btime()));
-    this->display_ctime_ =
-        std::format("{}", std::chrono::floor<std::chrono::seconds>(this->ctime()));
-    this->display_mtime_ =
-        std::format("{}", std::chrono::floor<std::chrono::seconds>(this->mtime()));
+    if (mime_type)
+    {
+        this->mime_type_ = mime_type;
+    }
+    else if (this->is_symlink_broken())
+    {
+        this->mime_type_ = vfs::mime_type::create_from_file(this->path_);
+    }
+    else if (std::filesystem::is_symlink(this->status()))
+    {
+        // mime type is of the symlink target
+        const auto target_status = file_status_from_mode(this->target_mode_);
+        this->mime_type_ =
+            vfs::mime_type::create_from_file(this->path_, target_status, this->target_size_);
+    }
+    else
+    {
+        this->mime_type_ =
+            vfs::mime_type::create_from_file(this->path_, this->status(), this->size());
+    }
 
     this->load_special_info();
 
-    // Cause file prem string to be regenerated as needed
-    this->display_perm_.clear();
+    this->clear_display_strings();
+}
 
-    return true;
+void
+vfs::file::clear_display_strings() noexcept
+{
+    const std::scoped_lock<std::mutex> lock(display_lock);
+    this->display_size_.clear();
+    this->display_size_bytes_.clear();
+    this->display_disk_size_.clear();
+    this->display_owner_ = {};
+    this->display_group_ = {};
+    this->display_atime_.clear();
+    this->display_btime_.clear();
+    this->display_ctime_.clear();
+    this->display_mtime_.clear();
+    this->display_perm_.clear();
 }
 
 const std::string_view
@@ -157,43 +373,76 @@ vfs::file::path() const noexcept
 const std::string_view
 vfs::file::uri() const noexcept
 {
+    const std::scoped_lock<std::mutex> lock(display_lock);
+    if (this->uri_.empty())
+    {
+        this->uri_ = Glib::filename_to_uri(this->path_.string());
+    }
     return this->uri_;
 }
 
+const vfs::file::stat_data&
+vfs::file::stat() const noexcept
+{
+    return this->file_stat_;
+}
+
+std::filesystem::file_status
+vfs::file::status() const noexcept
+{
+    // derived from the statx mode, no extra syscall
+    return file_status_from_mode(this->file_stat_.mode);
+}
+
 u64
 vfs::file::size() const noexcept
 {
-    return this->file_stat_.size();
+    return this->file_stat_.size;
 }
 
 u64
 vfs::file::size_on_disk() const noexcept
 {
-    return this->file_stat_.size_on_disk();
+    return this->file_stat_.blocks * S_BLKSIZE;
 }
 
 const std::string_view
 vfs::file::display_size() const noexcept
 {
+    const std::scoped_lock<std::mutex> lock(display_lock);
+    if (this->display_size_.empty())
+    {
+        this->display_size_ = vfs::utils::format_file_size(this->size());
+    }
     return this->display_size_;
 }
 
 const std::string_view
 vfs::file::display_size_in_bytes() const noexcept
 {
+    const std::scoped_lock<std::mutex> lock(display_lock);
+    if (this->display_size_bytes_.empty())
+    {
+        this->display_size_bytes_ = std::format("{:L}", this->size());
+    }
     return this->display_size_bytes_;
 }
 
 const std::string_view
 vfs::file::display_size_on_disk() const noexcept
 {
+    const std::scoped_lock<std::mutex> lock(display_lock);
+    if (this->display_disk_size_.empty())
+    {
+        this->display_disk_size_ = vfs::utils::format_file_size(this->size_on_disk());
+    }
     return this->display_disk_size_;
 }
 
 u64
 vfs::file::blocks() const noexcept
 {
-    return this->file_stat_.blocks();
+    return this->file_stat_.blocks;
 }
 
 const std::shared_ptr<vfs::mime_type>&
@@ -327,61 +576,117 @@ vfs::file::unload_thumbnail(const thumbnail_size size) noexcept
 const std::string_view
 vfs::file::display_owner() const noexcept
 {
+    {
+        const std::scoped_lock<std::mutex> lock(display_lock);
+        if (!this->display_owner_.empty())
+        {
+            return this->display_owner_;
+        }
+    }
+
+    // the lookup can block on a slow name service, the lock is only held to store it
+    const auto owner = vfs::id_names::user(this->file_stat_.uid);
+
+    const std::scoped_lock<std::mutex> lock(display_lock);
+    if (this->display_owner_.empty())
+    {
+        this->display_owner_ = owner;
+    }
     return this->display_owner_;
 }
 
 const std::string_view
 vfs::file::display_group() const noexcept
 {
+    {
+        const std::scoped_lock<std::mutex> lock(display_lock);
+        if (!this->display_group_.empty())
+        {
+            return this->display_group_;
+        }
+    }
+
+    // not locked, see display_owner()
+    const auto group = vfs::id_names::group(this->file_stat_.gid);
+
+    const std::scoped_lock<std::mutex> lock(display_lock);
+    if (this->display_group_.empty())
+    {
+        this->display_group_ = group;
+    }
     return this->display_group_;
 }
 
 const std::string_view
 vfs::file::display_atime() const noexcept
 {
+    const std::scoped_lock<std::mutex> lock(display_lock);
+    if (this->display_atime_.empty())
+    {
+        this->display_atime_ =
+            std::format("{}", std::chrono::floor<std::chrono::seconds>(this->atime()));
+    }
     return this->display_atime_;
 }
 
 const std::string_view
 vfs::file::display_btime() const noexcept
 {
+    const std::scoped_lock<std::mutex> lock(display_lock);
+    if (this->display_btime_.empty())
+    {
+        this->display_btime_ =
+            std::format("{}", std::chrono::floor<std::chrono::seconds>(this->btime()));
+    }
     return this->display_btime_;
 }
 
 const std::string_view
 vfs::file::display_ctime() const noexcept
 {
+    const std::scoped_lock<std::mutex> lock(display_lock);
+    if (this->display_ctime_.empty())
+    {
+        this->display_ctime_ =
+            std::format("{}", std::chrono::floor<std::chrono::seconds>(this->ctime()));
+    }
     return this->display_ctime_;
 }
 
 const std::string_view
 vfs::file::display_mtime() const noexcept
 {
+    const std::scoped_lock<std::mutex> lock(display_lock);
+    if (this->display_mtime_.empty())
+    {
+        this->display_mtime_ =
+            std::format("{}", std::chrono::floor<std::chrono::seconds>(this->mtime()));
+    }
     return this->display_mtime_;
 }
 
 const std::chrono::system_clock::time_point
 vfs::file::atime() const noexcept
 {
-    return this->file_stat_.atime();
+    return time_point_from_statx(this->file_stat_.atime);
 }
 
 const std::chrono::system_clock::time_point
 vfs::file::btime() const noexcept
 {
-    return this->file_stat_.btime();
+    return time_point_from_statx(this->file_stat_.btime);
 }
 
 const std::chrono::system_clock::time_point
 vfs::file::ctime() const noexcept
 {
-    return this->file_stat_.ctime();
+    return time_point_from_statx(this->file_stat_.ctime);
 }
 
 const std::chrono::system_clock::time_point
 vfs::file::mtime() const noexcept
 {
-    return this->file_stat_.mtime();
+    return time_point_from_statx(this->file_stat_.mtime);
 }
 
 const std::string
@@ -405,36 +710,36 @@ vfs::file::create_file_perm_string() const noexcept
     std::string perm = "----------";
 
     // File Type Permissions
-    if (std::filesystem::is_regular_file(this->status_))
+    if (std::filesystem::is_regular_file(this->status()))
     {
         perm[file_type] = '-';
     }
-    else if (std::filesystem::is_directory(this->status_))
+    else if (std::filesystem::is_directory(this->status()))
     {
         perm[file_type] = 'd';
     }
-    else if (std::filesystem::is_symlink(this->status_))
+    else if (std::filesystem::is_symlink(this->status()))
     {
         perm[file_type] = 'l';
     }
-    else if (std::filesystem::is_character_file(this->status_))
+    else if (std::filesystem::is_character_file(this->status()))
     {
         perm[file_type] = 'c';
     }
-    else if (std::filesystem::is_block_file(this->status_))
+    else if (std::filesystem::is_block_file(this->status()))
     {
         perm[file_type] = 'b';
     }
-    else if (std::filesystem::is_fifo(this->status_))
+    else if (std::filesystem::is_fifo(this->status()))
     {
         perm[file_type] = 'p';
     }
-    else if (std::filesystem::is_socket(this->status_))
+    else if (std::filesystem::is_socket(this->status()))
     {
         perm[file_type] = 's';
     }
 
-    const std::filesystem::perms p = this->status_.permissions();
+    const std::filesystem::perms p = this->status().permissions();
 
     // Owner
     if ((p & std::filesystem::perms::owner_read) != std::filesystem::perms::none)
@@ -532,6 +837,7 @@ vfs::file::create_file_perm_string() const noexcept
 const std::string_view
 vfs::file::display_permissions() noexcept
 {
+    const std::scoped_lock<std::mutex> lock(display_lock);
     if (this->display_perm_.empty())
     {
         this->display_perm_ = this->create_file_perm_string();
@@ -542,54 +848,47 @@ vfs::file::display_permissions() noexcept
 bool
 vfs::file::is_directory() const noexcept
 {
-    // return std::filesystem::is_directory(this->status);
-
-    if (std::filesystem::is_symlink(this->status_))
+    if (std::filesystem::is_symlink(this->status()))
     {
-        std::error_code ec;
-        const auto symlink_path = std::filesystem::read_symlink(this->path_, ec);
-        if (!ec)
-        {
-            return std::filesystem::is_directory(symlink_path);
-        }
+        return S_ISDIR(this->target_mode_);
     }
-    return std::filesystem::is_directory(this->status_);
+    return std::filesystem::is_directory(this->status());
 }
 
 bool
 vfs::file::is_regular_file() const noexcept
 {
-    return std::filesystem::is_regular_file(this->status_);
+    return std::filesystem::is_regular_file(this->status());
 }
 
 bool
 vfs::file::is_symlink() const noexcept
 {
-    return std::filesystem::is_symlink(this->status_);
+    return std::filesystem::is_symlink(this->status());
 }
 
 bool
 vfs::file::is_socket() const noexcept
 {
-    return std::filesystem::is_socket(this->status_);
+    return std::filesystem::is_socket(this->status());
 }
 
 bool
 vfs::file::is_fifo() const noexcept
 {
-    return std::filesystem::is_fifo(this->status_);
+    return std::filesystem::is_fifo(this->status());
 }
 
 bool
 vfs::file::is_block_file() const noexcept
 {
-    return std::filesystem::is_block_file(this->status_);
+    return std::filesystem::is_block_file(this->status());
 }
 
 bool
 vfs::file::is_character_file() const noexcept
 {
-    return std::filesystem::is_character_file(this->status_);
+    return std::filesystem::is_character_file(this->status());
 }
 
 bool
@@ -598,10 +897,22 @@ vfs::file::is_other() const noexcept
     return (!this->is_directory() && !this->is_regular_file() && !this->is_symlink());
 }
 
+bool
+vfs::file::is_symlink_broken() const noexcept
+{
+    return this->is_symlink() && this->target_mode_ == 0;
+}
+
+u64
+vfs::file::symlink_target_size() const noexcept
+{
+    return this->target_size_;
+}
+
 bool
 vfs::file::is_hidden() const noexcept
 {
-    return this->is_hidden_;
+    return this->name_.starts_with('.');
 }
 
 bool
@@ -613,61 +924,61 @@ vfs::file::is_desktop_entry() const noexcept
 bool
 vfs::file::is_compressed() const noexcept
 {
-    return this->file_stat_.is_compressed();
+    return (this->file_stat_.attributes & STATX_ATTR_COMPRESSED) != 0;
 }
 
 bool
 vfs::file::is_immutable() const noexcept
 {
-    return this->file_stat_.is_immutable();
+    return (this->file_stat_.attributes & STATX_ATTR_IMMUTABLE) != 0;
 }
 
 bool
 vfs::file::is_append() const noexcept
 {
-    return this->file_stat_.is_append();
+    return (this->file_stat_.attributes & STATX_ATTR_APPEND) != 0;
 }
 
 bool
 vfs::file::is_nodump() const noexcept
 {
-    return this->file_stat_.is_nodump();
+    return (this->file_stat_.attributes & STATX_ATTR_NODUMP) != 0;
 }
 
 bool
 vfs::file::is_encrypted() const noexcept
 {
-    return this->file_stat_.is_encrypted();
+    return (this->file_stat_.attributes & STATX_ATTR_ENCRYPTED) != 0;
 }
 
 bool
 vfs::file::is_automount() const noexcept
 {
-    return this->file_stat_.is_automount();
+    return (this->file_stat_.attributes & STATX_ATTR_AUTOMOUNT) != 0;
 }
 
 bool
 vfs::file::is_mount_root() const noexcept
 {
-    return this->file_stat_.is_mount_root();
+    return (this->file_stat_.attributes & STATX_ATTR_MOUNT_ROOT) != 0;
 }
 
 bool
 vfs::file::is_verity() const noexcept
 {
-    return this->file_stat_.is_verity();
+    return (this->file_stat_.attributes & STATX_ATTR_VERITY) != 0;
 }
 
 bool
 vfs::file::is_dax() const noexcept
 {
-    return this->file_stat_.is_dax();
+    return (this->file_stat_.attributes & STATX_ATTR_DAX) != 0;
 }
 
 std::filesystem::perms
 vfs::file::permissions() const noexcept
 {
-    return this->status_.permissions();
+    return this->status().permissions();
 }
 
 bool
@@ -762,6 +1073,10 @@ vfs::file::load_special_info() noexcept
         return;
     }
 
+    // the icon theme is shared by every directory loading worker thread
+    static std::mutex icon_lock;
+    const std::scoped_lock<std::mutex> lock(icon_lock);
+
     const i32 big_size = config::settings.icon_size_big;
     const i32 small_size = config::settings.icon_size_small;
     if (this->big_thumbnail_ == nullptr)
@@ -24,6 +24,8 @@
 
 #include <memory>
 
+#include <sys/stat.h>
+
 #include <gtkmm.h>
 
 #include <ztd/ztd.hxx>
@@ -37,8 +39,27 @@ namespace vfs
 struct file : public std::enable_shared_from_this<file>
 {
   public:
+    // the subset of struct statx that is kept for every file
+    struct stat_data
+    {
+        u64 size{0};
+        u64 blocks{0};
+        u64 ino{0};
+        u64 attributes{0};
+        struct ::statx_timestamp atime{};
+        struct ::statx_timestamp btime{};
+        struct ::statx_timestamp ctime{};
+        struct ::statx_timestamp mtime{};
+        u32 uid{0};
+        u32 gid{0};
+        u16 mode{0};
+    };
+
     file() = delete;
     file(const std::filesystem::path& file_path) noexcept;
+    file(const std::filesystem::path& file_path, const struct ::statx& stat) noexcept;
+    file(const std::filesystem::path& file_path, const stat_data& stat,
+         const std::shared_ptr<vfs::mime_type>& mime_type) noexcept;
     ~file() noexcept;
     file(const file& other) = delete;
     file(file&& other) = delete;
@@ -47,12 +68,27 @@ struct file : public std::enable_shared_from_this<file>
 
     [[nodiscard]] static const std::shared_ptr<vfs::file>
     create(const std::filesystem::path& path) noexcept;
+    // create using an already stat'ed file, see vfs::linux::dirent::scanner
+    [[nodiscard]] static const std::shared_ptr<vfs::file>
+    create(const std::filesystem::path& path, const struct ::statx& stat) noexcept;
+    // create using a known mime type, see vfs::dir_snapshot
+    [[nodiscard]] static const std::shared_ptr<vfs::file>
+    create(const std::filesystem::path& path, const stat_data& stat,
+           const std::shared_ptr<vfs::mime_type>& mime_type) noexcept;
+    // create for the new name of a file renamed within its directory, the path of a
+    // vfs::file never changes. loaded thumbnails are kept and the mime type is only
+    // detected again if the extension changed. nullptr if the file no longer exists.
+    [[nodiscard]] static const std::shared_ptr<vfs::file>
+    create_renamed(const std::shared_ptr<vfs::file>& file,
+                   const std::filesystem::path& path) noexcept;
 
     [[nodiscard]] const std::string_view name() const noexcept;
 
     [[nodiscard]] const std::filesystem::path& path() const noexcept;
     [[nodiscard]] const std::string_view uri() const noexcept;
 
+    [[nodiscard]] const stat_data& stat() const noexcept;
+
     [[nodiscard]] u64 size() const noexcept;
     [[nodiscard]] u64 size_on_disk() const noexcept;
 
@@ -99,6 +135,10 @@ struct file : public std::enable_shared_from_this<file>
     [[nodiscard]] bool is_character_file() const noexcept;
     [[nodiscard]] bool is_other() const noexcept;
 
+    [[nodiscard]] bool is_symlink_broken() const noexcept;
+    // size of the file a symlink points to, 0 if not a symlink or broken
+    [[nodiscard]] u64 symlink_target_size() const noexcept;
+
     [[nodiscard]] bool is_hidden() const noexcept;
 
     [[nodiscard]] bool is_desktop_entry() const noexcept;
@@ -127,36 +167,49 @@ struct file : public std::enable_shared_from_this<file>
     // update file info
     [[nodiscard]] bool update() noexcept;
 
+    // approximate memory used by this file, including loaded thumbnails
+    [[nodiscard]] u64 memory_usage() const noexcept;
+
   private:
-    ztd::statx file_stat_; // cached copy of struct statx()
-    std::filesystem::file_status status_;
+    stat_data file_stat_{}; // cached copy of struct statx()
+
+    // symlink target, resolved once in update_info()
+    u64 target_size_{0};
+    u16 target_mode_{0}; // 0 if the symlink is broken
 
     std::filesystem::path path_; // real path on file system
-    std::string uri_;            // uri of the real path on file system
-
-    std::string name_;                          // real name on file system
-    std::string display_size_;                  // displayed human-readable file size
-    std::string display_size_bytes_;            // displayed file size in bytes
-    std::string display_disk_size_;             // displayed human-readable file size on disk
-    std::string display_owner_;                 // displayed owner
-    std::string display_group_;                 // displayed group
-    std::string display_atime_;                 // displayed accessed time
-    std::string display_btime_;                 // displayed created time
-    std::string display_ctime_;                 // displayed last status change time
-    std::string display_mtime_;                 // displayed modification time
-    std::string display_perm_;                  // displayed permission in string form
+    std::string_view name_;      // real name on file system, a view into path_
+    mutable std::string uri_;    // uri of the real path on file system
+
+    // display strings are created on first use, empty until then
+    mutable std::string display_size_;       // displayed human-readable file size
+    mutable std::string display_size_bytes_; // displayed file size in bytes
+    mutable std::string display_disk_size_;  // displayed human-readable file size on disk
+    mutable std::string_view display_owner_; // displayed owner, see vfs::id_names
+    mutable std::string_view display_group_; // displayed group, see vfs::id_names
+    mutable std::string display_atime_;      // displayed accessed time
+    mutable std::string display_btime_;      // displayed created time
+    mutable std::string display_ctime_;      // displayed last status change time
+    mutable std::string display_mtime_;      // displayed modification time
+    std::string display_perm_;               // displayed permission in string form
+
     std::shared_ptr<vfs::mime_type> mime_type_; // mime type related information
     GdkPixbuf* big_thumbnail_{nullptr};         // thumbnail of the file
     GdkPixbuf* small_thumbnail_{nullptr};       // thumbnail of the file
 
     bool is_special_desktop_entry_{false}; // is a .desktop file
 
-    bool is_hidden_{false}; // if the filename starts with '.'
-
     // std::vector<metadata_data> metadata_{};
 
   private:
+    void init_name() noexcept;
+    // file type and permissions from the statx mode
+    [[nodiscard]] std::filesystem::file_status status() const noexcept;
+    // mime_type is detected if it is nullptr
+    void update_info(const std::shared_ptr<vfs::mime_type>& mime_type = nullptr) noexcept;
     void load_special_info() noexcept;
+    // cause display strings to be regenerated as needed
+    void clear_display_strings() noexcept;
 
     [[nodiscard]] const std::string create_file_perm_string() const noexcept;
 
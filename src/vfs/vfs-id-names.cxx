@@ -0,0 +1,160 @@
+/**
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+#include <string_view>
+
+#include <filesystem>
+
+#include <unordered_map>
+#include <unordered_set>
+
+#include <mutex>
+
+#include <chrono>
+
+#include <system_error>
+
+#include <sys/types.h>
+
+#include <ztd/ztd.hxx>
+#include <ztd/ztd_logger.hxx>
+
+#include "vfs/vfs-id-names.hxx"
+
+// how often /etc/passwd and /etc/group are checked for changes
+static constexpr std::chrono::seconds DB_CHECK_INTERVAL{5};
+
+namespace global
+{
+std::mutex id_names_lock;
+
+// every name ever returned, never shrinks so returned views stay valid
+std::unordered_set<std::string> id_names_pool;
+
+std::unordered_map<uid_t, std::string_view> user_names;
+std::unordered_map<gid_t, std::string_view> group_names;
+
+std::chrono::steady_clock::time_point id_names_last_check;
+std::filesystem::file_time_type passwd_mtime;
+std::filesystem::file_time_type group_mtime;
+
+// NSS lookups are serialized, getpwuid()/getgrgid() are not reentrant
+std::mutex nss_lock;
+} // namespace global
+
+static std::filesystem::file_time_type
+db_mtime(const std::filesystem::path& path) noexcept
+{
+    std::error_code ec;
+    const auto mtime = std::filesystem::last_write_time(path, ec);
+    return ec ? std::filesystem::file_time_type{} : mtime;
+}
+
+// clear the cached ids if the databases changed, must hold global::id_names_lock
+static void
+check_databases() noexcept
+{
+    const auto now = std::chrono::steady_clock::now();
+    if (now - global::id_names_last_check < DB_CHECK_INTERVAL)
+    {
+        return;
+    }
+    global::id_names_last_check = now;
+
+    const auto passwd_mtime = db_mtime("/etc/passwd");
+    const auto group_mtime = db_mtime("/etc/group");
+    if (passwd_mtime != global::passwd_mtime || group_mtime != global::group_mtime)
+    {
+        global::passwd_mtime = passwd_mtime;
+        global::group_mtime = group_mtime;
+
+        global::user_names.clear();
+        global::group_names.clear();
+    }
+}
+
+static const std::string_view
+intern(const std::string& name) noexcept
+{
+    return *global::id_names_pool.insert(name).first;
+}
+
+const std::string_view
+vfs::id_names::user(const uid_t uid) noexcept
+{
+    {
+        const std::scoped_lock<std::mutex> lock(global::id_names_lock);
+        check_databases();
+        if (global::user_names.contains(uid))
+        {
+            return global::user_names.at(uid);
+        }
+    }
+
+    std::string name;
+    {
+        const std::scoped_lock<std::mutex> lock(global::nss_lock);
+        const auto pw = ztd::passwd(uid);
+        name = pw.name();
+    }
+    if (name.empty())
+    {
+        name = std::to_string(uid);
+    }
+
+    const std::scoped_lock<std::mutex> lock(global::id_names_lock);
+    const auto interned = intern(name);
+    global::user_names.insert({uid, interned});
+    return interned;
+}
+
+const std::string_view
+vfs::id_names::group(const gid_t gid) noexcept
+{
+    {
+        const std::scoped_lock<std::mutex> lock(global::id_names_lock);
+        check_databases();
+        if (global::group_names.contains(gid))
+        {
+            return global::group_names.at(gid);
+        }
+    }
+
+    std::string name;
+    {
+        const std::scoped_lock<std::mutex> lock(global::nss_lock);
+        const auto gr = ztd::group(gid);
+        name = gr.name();
+    }
+    if (name.empty())
+    {
+        name = std::to_string(gid);
+    }
+
+    const std::scoped_lock<std::mutex> lock(global::id_names_lock);
+    const auto interned = intern(name);
+    global::group_names.insert({gid, interned});
+    return interned;
+}
+
+void
+vfs::id_names::invalidate() noexcept
+{
+    const std::scoped_lock<std::mutex> lock(global::id_names_lock);
+
+    global::user_names.clear();
+    global::group_names.clear();
+}
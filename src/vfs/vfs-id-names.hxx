@@ -0,0 +1,39 @@
+/**
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <string_view>
+
+#include <sys/types.h>
+
+/**
+ * Process wide cache of user and group names.
+ *
+ * Names are interned, the returned std::string_view stays valid for the
+ * lifetime of the program. The cache is cleared when /etc/passwd or
+ * /etc/group are modified.
+ */
+namespace vfs::id_names
+{
+// name of a user, the numeric id if the user does not exist
+[[nodiscard]] const std::string_view user(const uid_t uid) noexcept;
+
+// name of a group, the numeric id if the group does not exist
+[[nodiscard]] const std::string_view group(const gid_t gid) noexcept;
+
+// drop every cached name, names will be looked up again on next use
+void invalidate() noexcept;
+} // namespace vfs::id_names
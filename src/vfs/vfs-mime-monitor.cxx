@@ -119,8 +119,12 @@ vfs::mime_monitor() noexcept
     global::user_mime_monitor = mime_monitor::create(vfs::dir::create(path));
 
     // ztd::logger::debug("MIME-UPDATE watch started");
-    global::user_mime_monitor->dir->add_event<spacefm::signal::file_created>(
-        std::bind(&mime_monitor::on_mime_change, std::placeholders::_1));
+    global::user_mime_monitor->dir->add_event<spacefm::signal::file_changes>(
+        [](const vfs::dir::change_set& changes)
+        {
+            (void)changes;
+            mime_monitor::on_mime_change(nullptr);
+        });
     global::user_mime_monitor->dir->add_event<spacefm::signal::file_changed>(
         std::bind(&mime_monitor::on_mime_change, std::placeholders::_1));
     global::user_mime_monitor->dir->add_event<spacefm::signal::file_deleted>(
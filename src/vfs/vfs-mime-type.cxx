@@ -71,6 +71,15 @@ vfs::mime_type::create_from_file(const std::filesystem::path& path) noexcept
     return vfs::mime_type::create_from_type(vfs::detail::mime_type::get_by_file(path));
 }
 
+const std::shared_ptr<vfs::mime_type>
+vfs::mime_type::create_from_file(const std::filesystem::path& path,
+                                 const std::filesystem::file_status& status,
+                                 const u64 size) noexcept
+{
+    return vfs::mime_type::create_from_type(
+        vfs::detail::mime_type::get_by_file(path, status, size));
+}
+
 const std::shared_ptr<vfs::mime_type>
 vfs::mime_type::create_from_type(const std::string_view type) noexcept
 {
@@ -55,6 +55,10 @@ struct mime_type
 
     [[nodiscard]] static const std::shared_ptr<vfs::mime_type>
     create_from_file(const std::filesystem::path& path) noexcept;
+    // use an already known file status and size, avoids stat'ing the file again
+    [[nodiscard]] static const std::shared_ptr<vfs::mime_type>
+    create_from_file(const std::filesystem::path& path, const std::filesystem::file_status& status,
+                     const u64 size) noexcept;
 
     [[nodiscard]] static const std::shared_ptr<vfs::mime_type>
     create_from_type(const std::string_view type) noexcept;
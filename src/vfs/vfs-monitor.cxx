@@ -18,9 +18,27 @@
  * along with this program. If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <string>
+#include <string_view>
+
 #include <filesystem>
 
 #include <array>
+#include <vector>
+
+#include <unordered_map>
+#include <unordered_set>
+
+#include <algorithm>
+#include <ranges>
+
+#include <memory>
+
+#include <mutex>
+
+#include <optional>
+
+#include <utility>
 
 #include <system_error>
 
@@ -28,8 +46,8 @@
 #include <cstring>
 
 #include <sys/inotify.h>
+#include <unistd.h>
 
-#include <gtkmm.h>
 #include <glibmm.h>
 #include <sigc++/sigc++.h>
 
@@ -40,134 +58,425 @@
 
 #include "vfs/vfs-monitor.hxx"
 
-vfs::monitor::monitor(const std::filesystem::path& path, const callback_t& callback) noexcept(false)
-    : path_(path), callback_(callback)
+namespace
+{
+struct subscriber
+{
+    std::filesystem::path path;
+    vfs::monitor::callback_t callback;
+    i32 wd{-1};               // -1 once the kernel has removed the watch
+    bool is_directory{false}; // event names are relative to path, else to its parent
+
+    [[nodiscard]] std::filesystem::path
+    event_path(const std::string_view name) const noexcept
+    {
+        if (name.empty())
+        {
+            return this->path;
+        }
+        if (this->is_directory)
+        {
+            return this->path / name;
+        }
+        return this->path.parent_path() / name;
+    }
+};
+
+struct changed_key
+{
+    i32 wd{-1};
+    std::string_view name;
+
+    bool operator==(const changed_key& other) const noexcept = default;
+};
+
+struct changed_key_hash
+{
+    [[nodiscard]] usize
+    operator()(const changed_key& key) const noexcept
+    {
+        return std::hash<std::string_view>{}(key.name) ^ std::hash<i32>{}(key.wd);
+    }
+};
+
+/**
+ * The process wide inotify instance.
+ *
+ * Every watch keeps the ids of its subscribers, inotify returns the same
+ * watch descriptor when the same inode is watched again so a path watched
+ * by several monitors only uses one watch. The fd is drained with large
+ * reads from a single main loop source.
+ */
+struct inotify
+{
+    [[nodiscard]] u64 subscribe(const std::filesystem::path& path,
+                                const vfs::monitor::callback_t& callback) noexcept(false);
+    void unsubscribe(const u64 id) noexcept;
+
+    [[nodiscard]] vfs::monitor::stats_data stats() noexcept;
+
+  private:
+    void open() noexcept(false);
+
+    [[nodiscard]] bool on_inotify_event(const Glib::IOCondition condition) noexcept;
+    // old_name is only set for a rename, see pending_move_
+    void dispatch_event(const i32 wd, const u32 mask, const std::string_view name,
+                        const std::string_view old_name = "") noexcept;
+
+    static constexpr u32 watch_mask{IN_MODIFY | IN_CREATE | IN_DELETE | IN_DELETE_SELF | IN_MOVE |
+                                    IN_MOVE_SELF | IN_UNMOUNT | IN_ATTRIB};
+
+    i32 fd_{-1};
+    sigc::connection signal_io_handler_;
+
+    u64 next_id_{1};
+    std::unordered_map<u64, std::shared_ptr<subscriber>> subscribers_;
+    // subscriber ids of every watch descriptor
+    std::unordered_map<i32, std::vector<u64>> watches_;
+    // monitors can be destroyed from worker threads when they drop the last dir reference
+    std::mutex lock_;
+
+    vfs::monitor::stats_data stats_;
+
+    // changed events already sent during the current read, names point into buffer_
+    std::unordered_set<changed_key, changed_key_hash> changed_;
+
+    // a rename within a directory is queued as IN_MOVED_FROM directly followed by
+    // IN_MOVED_TO with the same cookie. the IN_MOVED_FROM is held until the next event,
+    // and sent as a delete if that is not its IN_MOVED_TO.
+    struct pending_move
+    {
+        i32 wd;
+        u32 cookie;
+        std::string name;
+    };
+    std::optional<pending_move> pending_move_{std::nullopt};
+
+    alignas(inotify_event) std::array<char, 64 * 1024> buffer_{};
+};
+} // namespace
+
+static inotify&
+get_inotify() noexcept
+{
+    // never destroyed, monitors can still be destroyed during static destruction
+    static auto* const instance = new inotify;
+    return *instance;
+}
+
+void
+inotify::open() noexcept(false)
 {
-    this->inotify_fd_ = inotify_init();
-    if (this->inotify_fd_ == -1)
+    this->fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (this->fd_ == -1)
     {
         throw std::system_error(errno, std::generic_category(), "Failed to initialize inotify");
     }
 
-    this->inotify_io_channel_ = Glib::IOChannel::create_from_fd(this->inotify_fd_);
-    this->inotify_io_channel_->set_buffered(true);
 #if (GTK_MAJOR_VERSION == 4)
-    this->inotify_io_channel_->set_flags(Glib::IOFlags::NONBLOCK);
-
     this->signal_io_handler_ =
-        Glib::signal_io().connect(sigc::mem_fun(*this, &monitor::on_inotify_event),
-                                  this->inotify_io_channel_,
+        Glib::signal_io().connect(sigc::mem_fun(*this, &inotify::on_inotify_event),
+                                  this->fd_,
                                   Glib::IOCondition::IO_IN | Glib::IOCondition::IO_PRI |
                                       Glib::IOCondition::IO_HUP | Glib::IOCondition::IO_ERR);
 #elif (GTK_MAJOR_VERSION == 3)
-    this->inotify_io_channel_->set_flags(Glib::IO_FLAG_NONBLOCK);
-
     this->signal_io_handler_ =
-        Glib::signal_io().connect(sigc::mem_fun(this, &monitor::on_inotify_event),
-                                  this->inotify_io_channel_,
+        Glib::signal_io().connect(sigc::mem_fun(this, &inotify::on_inotify_event),
+                                  this->fd_,
                                   Glib::IOCondition::IO_IN | Glib::IOCondition::IO_PRI |
                                       Glib::IOCondition::IO_HUP | Glib::IOCondition::IO_ERR);
 #endif
+}
+
+u64
+inotify::subscribe(const std::filesystem::path& path,
+                   const vfs::monitor::callback_t& callback) noexcept(false)
+{
+    const std::scoped_lock<std::mutex> lock(this->lock_);
+
+    if (this->fd_ == -1)
+    {
+        this->open();
+    }
 
     // inotify does not follow symlinks, need to get real path
-    const auto real_path = std::filesystem::absolute(this->path_);
+    const auto real_path = std::filesystem::absolute(path);
 
-    this->inotify_wd_ = inotify_add_watch(this->inotify_fd_,
-                                          real_path.c_str(),
-                                          IN_MODIFY | IN_CREATE | IN_DELETE | IN_DELETE_SELF |
-                                              IN_MOVE | IN_MOVE_SELF | IN_UNMOUNT | IN_ATTRIB);
-    if (this->inotify_wd_ == -1)
+    const auto wd = inotify_add_watch(this->fd_, real_path.c_str(), watch_mask);
+    if (wd == -1)
     {
         throw std::system_error(errno,
                                 std::generic_category(),
                                 std::format("Failed to add inotify watch on '{}' ({})",
                                             real_path.string(),
-                                            this->path_.string()));
+                                            path.string()));
     }
 
-    // ztd::logger::debug("vfs::monitor::monitor({})  {} ({})  fd={} wd={}", ztd::logger::utils::ptr(this), real_path, this->path_, this->inotify_fd_, this->inotify_wd_);
+    const auto id = this->next_id_++;
+    this->subscribers_.insert(
+        {id,
+         std::make_shared<subscriber>(path, callback, wd, std::filesystem::is_directory(path))});
+    this->watches_[wd].push_back(id);
+
+    // ztd::logger::debug("inotify::subscribe({})  {} ({})  wd={} subscribers={}", id, real_path, path, wd, this->watches_[wd].size());
+
+    return id;
 }
 
-vfs::monitor::~monitor() noexcept
+void
+inotify::unsubscribe(const u64 id) noexcept
 {
-    // ztd::logger::debug("vfs::monitor::~monitor({}) {}", ztd::logger::utils::ptr(this),this->path_);
+    const std::scoped_lock<std::mutex> lock(this->lock_);
 
-    this->signal_io_handler_.disconnect();
+    const auto it = this->subscribers_.find(id);
+    if (it == this->subscribers_.cend())
+    {
+        return;
+    }
+    const auto wd = it->second->wd;
+    this->subscribers_.erase(it);
 
-    if (this->inotify_fd_ != -1)
+    const auto watch = this->watches_.find(wd);
+    if (watch == this->watches_.cend())
+    { // watch already removed by the kernel
+        return;
+    }
+    std::erase(watch->second, id);
+    if (watch->second.empty())
     {
-        inotify_rm_watch(this->inotify_fd_, this->inotify_wd_);
-        close(this->inotify_fd_);
+        inotify_rm_watch(this->fd_, wd);
+        this->watches_.erase(watch);
     }
 }
 
-void
-vfs::monitor::dispatch_event(const vfs::monitor::event event,
-                             const std::filesystem::path& path) const noexcept
+vfs::monitor::stats_data
+inotify::stats() noexcept
 {
-    // ztd::logger::debug("vfs::monitor::dispatch_event({})  {}   {}", ztd::logger::utils::ptr(this), magic_enum::enum_name(event), path.string());
-    this->callback_(event, path);
+    const std::scoped_lock<std::mutex> lock(this->lock_);
+
+    return this->stats_;
 }
 
 bool
-vfs::monitor::on_inotify_event(const Glib::IOCondition condition) const noexcept
+inotify::on_inotify_event(const Glib::IOCondition condition) noexcept
 {
-    // ztd::logger::debug("vfs::monitor::on_inotify_event({})  {}", ztd::logger::utils::ptr(this), this->path_);
-    static constexpr auto EVENT_SIZE = (sizeof(inotify_event));
-    static constexpr auto EVENT_BUF_LEN = (1024 * (EVENT_SIZE + 16));
-
     if (condition == Glib::IOCondition::IO_HUP || condition == Glib::IOCondition::IO_ERR)
     {
         ztd::logger::error("Disconnected from inotify server");
         return false;
     }
 
-    std::array<char, EVENT_BUF_LEN> buffer{};
-    const auto length = read(this->inotify_fd_, buffer.data(), EVENT_BUF_LEN);
-    if (length < 0)
+    while (true)
     {
-        ztd::logger::error("Error reading inotify event: {}", std::strerror(errno));
-        return false;
+        const auto length = read(this->fd_, this->buffer_.data(), this->buffer_.size());
+        if (length <= 0)
+        {
+            if (length == -1 && errno != EAGAIN && errno != EINTR)
+            {
+                ztd::logger::error("Error reading inotify event: {}", std::strerror(errno));
+                return false;
+            }
+            break;
+        }
+
+        this->changed_.clear();
+
+        isize offset = 0;
+        while (offset < length)
+        {
+            const auto* const event = (inotify_event*)(this->buffer_.data() + offset);
+            offset += sizeof(inotify_event) + event->len;
+
+            // events without a name are for the watched path itself
+            const std::string_view name = event->len ? event->name : "";
+
+            if (this->pending_move_)
+            {
+                const auto from = std::move(this->pending_move_.value());
+                this->pending_move_.reset();
+
+                if ((event->mask & IN_MOVED_TO) && event->cookie == from.cookie &&
+                    event->wd == from.wd)
+                {
+                    this->dispatch_event(event->wd, event->mask, name, from.name);
+                    continue;
+                }
+                this->dispatch_event(from.wd, IN_MOVED_FROM, from.name);
+            }
+
+            if ((event->mask & IN_MOVED_FROM) && !name.empty())
+            {
+                this->pending_move_ = pending_move{event->wd, event->cookie, std::string(name)};
+                continue;
+            }
+
+            this->dispatch_event(event->wd, event->mask, name);
+        }
     }
 
-    u32 i = 0;
-    while (i < length)
+    // moved out of the watched directory, or its IN_MOVED_TO has not been queued yet
+    if (this->pending_move_)
     {
-        auto* const event = (inotify_event*)&buffer[i];
-        if (event->len)
+        const auto from = std::move(this->pending_move_.value());
+        this->pending_move_.reset();
+
+        this->dispatch_event(from.wd, IN_MOVED_FROM, from.name);
+    }
+
+    return true;
+}
+
+[[nodiscard]] static vfs::monitor::event
+monitor_event_from_mask(const u32 mask) noexcept
+{
+    if (mask & IN_Q_OVERFLOW)
+    {
+        return vfs::monitor::event::overflow;
+    }
+    if (mask & (IN_CREATE | IN_MOVED_TO))
+    {
+        return vfs::monitor::event::created;
+    }
+    if (mask & (IN_DELETE | IN_MOVED_FROM | IN_DELETE_SELF | IN_MOVE_SELF | IN_UNMOUNT))
+    {
+        return vfs::monitor::event::deleted;
+    }
+    if (mask & (IN_MODIFY | IN_ATTRIB))
+    {
+        return vfs::monitor::event::changed;
+    }
+    return vfs::monitor::event::other;
+}
+
+void
+inotify::dispatch_event(const i32 wd, const u32 mask, const std::string_view name,
+                        const std::string_view old_name) noexcept
+{
+    const auto monitor_event =
+        old_name.empty() ? monitor_event_from_mask(mask) : vfs::monitor::event::renamed;
+
+    std::vector<std::shared_ptr<subscriber>> targets;
+    {
+        const std::scoped_lock<std::mutex> lock(this->lock_);
+
+        this->stats_.processed += old_name.empty() ? 1 : 2;
+
+        if (monitor_event == vfs::monitor::event::overflow)
         {
-            const std::filesystem::path event_filename = event->name;
+            this->stats_.overflows += 1;
+
+            ztd::logger::warn("inotify event queue overflowed, {} monitors will rescan",
+                              this->subscribers_.size());
 
-            std::filesystem::path event_path;
-            if (std::filesystem::is_directory(this->path_))
+            targets.reserve(this->subscribers_.size());
+            for (const auto& target : this->subscribers_ | std::views::values)
             {
-                event_path = this->path_ / event_filename;
+                targets.push_back(target);
             }
-            else
+        }
+        else
+        {
+            const auto watch = this->watches_.find(wd);
+            if (watch == this->watches_.cend())
             {
-                event_path = this->path_.parent_path() / event_filename;
+                if (!(mask & IN_IGNORED))
+                {
+                    this->stats_.dropped += 1;
+                }
+                return;
+            }
+
+            if (mask & IN_IGNORED)
+            { // the kernel removed the watch, its descriptor can be reused
+                for (const auto id : watch->second)
+                {
+                    this->subscribers_.at(id)->wd = -1;
+                }
+                this->watches_.erase(watch);
+                return;
             }
 
-            vfs::monitor::event monitor_event = event::other;
-            if (event->mask & (IN_CREATE | IN_MOVED_TO))
+            // a file that changes many times between reads only needs to be stat'ed once,
+            // any other event for the file has to be sent in order
+            if (monitor_event == vfs::monitor::event::changed)
             {
-                monitor_event = event::created;
+                if (!this->changed_.insert({wd, name}).second)
+                {
+                    this->stats_.coalesced += 1;
+                    return;
+                }
             }
-            else if (event->mask & (IN_DELETE | IN_MOVED_FROM | IN_DELETE_SELF | IN_UNMOUNT))
+            else
             {
-                monitor_event = event::deleted;
+                this->changed_.erase({wd, name});
+                if (monitor_event == vfs::monitor::event::renamed)
+                {
+                    this->changed_.erase({wd, old_name});
+                    this->stats_.renamed += 1;
+                }
             }
-            else if (event->mask & (IN_MODIFY | IN_ATTRIB))
+
+            targets.reserve(watch->second.size());
+            for (const auto id : watch->second)
             {
-                monitor_event = event::changed;
+                targets.push_back(this->subscribers_.at(id));
+            }
+        }
+    }
+
+    // callbacks can destroy monitors, including those still in targets,
+    // a subscriber is only called while it is still subscribed
+    for (const auto& target : targets)
+    {
+        {
+            const std::scoped_lock<std::mutex> lock(this->lock_);
+            if (target.use_count() == 1)
+            { // unsubscribed by an earlier callback
+                continue;
             }
+        }
 
-            // ztd::logger::debug("inotify-event MASK={} EVENT({})={}", event->mask, magic_enum::enum_name(monitor_event), event_path.string());
+        const auto event_path = target->event_path(name);
+        const auto old_path =
+            old_name.empty() ? std::filesystem::path() : target->event_path(old_name);
+
+        // ztd::logger::debug("inotify-event MASK={} EVENT({})={}", mask, magic_enum::enum_name(monitor_event), event_path.string());
+
+        target->callback(monitor_event, event_path, old_path);
+    }
+}
 
-            this->dispatch_event(monitor_event, event_path);
+vfs::monitor::monitor(const std::filesystem::path& path, const callback_t& callback) noexcept(false)
+    : id_(get_inotify().subscribe(path, callback))
+{
+}
+
+vfs::monitor::~monitor() noexcept
+{
+    if (this->id_ != 0)
+    {
+        get_inotify().unsubscribe(this->id_);
+    }
+}
+
+vfs::monitor::monitor(monitor&& other) noexcept : id_(std::exchange(other.id_, 0)) {}
+
+vfs::monitor&
+vfs::monitor::operator=(monitor&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (this->id_ != 0)
+        {
+            get_inotify().unsubscribe(this->id_);
         }
-        i += EVENT_SIZE + event->len;
+        this->id_ = std::exchange(other.id_, 0);
     }
+    return *this;
+}
 
-    return true;
+vfs::monitor::stats_data
+vfs::monitor::stats() noexcept
+{
+    return get_inotify().stats();
 }
@@ -21,14 +21,18 @@
 
 #include <functional>
 
-#include <gtkmm.h>
-#include <glibmm.h>
-#include <sigc++/sigc++.h>
-
 #include <ztd/ztd.hxx>
 
 namespace vfs
 {
+/**
+ * Watches a directory, or a file, for changes.
+ *
+ * Every monitor is a subscriber of one process wide inotify instance,
+ * monitors of the same path share a single watch that is removed
+ * when the last of them is destroyed. Events are read and dispatched
+ * on the main loop.
+ */
 struct monitor
 {
     enum class event
@@ -36,37 +40,40 @@ struct monitor
         created,
         deleted,
         changed,
+        // renamed within the directory, old_path is the path before
+        renamed,
+        // the kernel event queue overflowed and events were lost,
+        // sent to every monitor with its own path, anything may have changed
+        overflow,
         other,
     };
 
-    // Callback function which will be called when monitored events happen
-    using callback_t =
-        std::function<void(const vfs::monitor::event event, const std::filesystem::path& path)>;
+    struct stats_data
+    {
+        u64 processed{0}; // events read from inotify
+        u64 dropped{0};   // events for watches without subscribers
+        u64 coalesced{0}; // changes not sent, already sent for the same file in the same read
+        u64 overflows{0}; // times the kernel event queue overflowed
+        u64 renamed{0};   // IN_MOVED_FROM and IN_MOVED_TO pairs sent as one rename
+    };
+
+    // Callback function which will be called when monitored events happen,
+    // old_path is empty unless the event is renamed
+    using callback_t = std::function<void(const vfs::monitor::event event,
+                                          const std::filesystem::path& path,
+                                          const std::filesystem::path& old_path)>;
 
     monitor() = default;
     monitor(const std::filesystem::path& path, const callback_t& callback) noexcept(false);
     ~monitor() noexcept;
     monitor(const monitor& other) = delete;
-    monitor(monitor&& other) = delete;
+    monitor(monitor&& other) noexcept;
     monitor& operator=(const monitor& other) = delete;
-    monitor& operator=(monitor&& other) = default;
-
-  private:
-    [[nodiscard]] bool on_inotify_event(const Glib::IOCondition condition) const noexcept;
-    void dispatch_event(const event event, const std::filesystem::path& path) const noexcept;
+    monitor& operator=(monitor&& other) noexcept;
 
-    i32 inotify_fd_{-1};
-    i32 inotify_wd_{-1};
+    [[nodiscard]] static stats_data stats() noexcept;
 
-    std::filesystem::path path_;
-
-#if (GTK_MAJOR_VERSION == 4)
-    Glib::RefPtr<Glib::IOChannel> inotify_io_channel_ = nullptr;
-#elif (GTK_MAJOR_VERSION == 3)
-    Glib::RefPtr<Glib::IOChannel> inotify_io_channel_;
-#endif
-    sigc::connection signal_io_handler_;
-
-    callback_t callback_;
+  private:
+    u64 id_{0}; // subscription to the shared inotify instance, 0 if not watching
 };
 } // namespace vfs
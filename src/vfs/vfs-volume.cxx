@@ -29,6 +29,10 @@
 
 #include <algorithm>
 
+#include <chrono>
+
+#include <charconv>
+
 #include <memory>
 
 #include <system_error>
@@ -656,18 +660,13 @@ vfs::volume_remove_callback(vfs::volume::callback_t cb, void* user_data) noexcep
     }
 }
 
-bool
-vfs::volume_dir_avoid_changes(const std::filesystem::path& dir) noexcept
+// filesystem type of a non-block device dir, i.e. nfs or fuse.sshfs
+static std::optional<std::string>
+dir_fstype(const std::filesystem::path& dir) noexcept
 {
-    // determines if file change detection should be disabled for this
-    // dir (eg nfs stat calls block when a write is in progress so file
-    // change detection is unwanted)
-    // return false to detect changes in this dir, true to avoid change detection
-
-    // ztd::logger::debug("vfs::volume_dir_avoid_changes({})", dir);
     if (!std::filesystem::exists(dir) || !global::udev.is_initialized())
     {
-        return false;
+        return std::nullopt;
     }
 
     const auto canon = std::filesystem::canonical(dir);
@@ -676,11 +675,23 @@ vfs::volume_dir_avoid_changes(const std::filesystem::path& dir) noexcept
     const auto stat = ztd::stat(canon, ec);
     if (ec || stat.is_block_file())
     {
-        return false;
+        return std::nullopt;
     }
     // ztd::logger::debug("    stat.dev() = {}:{}", gnu_dev_major(stat.dev()), gnu_dev_minor(stat.dev()));
 
-    const auto check_fstype = devmount_fstype(stat.dev());
+    return devmount_fstype(stat.dev());
+}
+
+bool
+vfs::volume_dir_avoid_changes(const std::filesystem::path& dir) noexcept
+{
+    // determines if file change detection should be disabled for this
+    // dir (eg nfs stat calls block when a write is in progress so file
+    // change detection is unwanted)
+    // return false to detect changes in this dir, true to avoid change detection
+
+    // ztd::logger::debug("vfs::volume_dir_avoid_changes({})", dir);
+    const auto check_fstype = dir_fstype(dir);
     if (!check_fstype)
     {
         return false;
@@ -704,6 +715,41 @@ vfs::volume_dir_avoid_changes(const std::filesystem::path& dir) noexcept
     return is_blacklisted;
 }
 
+std::chrono::seconds
+vfs::volume_dir_poll_interval(const std::filesystem::path& dir) noexcept
+{
+    const auto check_fstype = dir_fstype(dir);
+    if (!check_fstype)
+    {
+        return std::chrono::seconds(0);
+    }
+    const std::string& fstype = check_fstype.value();
+
+    // "nfs=10 fuse.sshfs=15", the first filesystem matching the dir is used
+    auto dev_change_poll = xset_get_s(xset::name::dev_change_poll).value_or("");
+    std::ranges::replace(dev_change_poll, ',', ' ');
+    for (const auto& entry : ztd::split(dev_change_poll, " "))
+    {
+        const auto separator = entry.find('=');
+        if (separator == std::string::npos || !fstype.contains(entry.substr(0, separator)))
+        {
+            continue;
+        }
+
+        const auto value = std::string_view(entry).substr(separator + 1);
+        u32 seconds = 0;
+        const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), seconds);
+        if (ec != std::errc() || ptr != value.data() + value.size())
+        {
+            ztd::logger::warn("Invalid change polling interval '{}'", entry);
+            continue;
+        }
+        return std::chrono::seconds(seconds);
+    }
+
+    return std::chrono::seconds(0);
+}
+
 /*
  * vfs::volume
  */
@@ -25,6 +25,8 @@
 
 #include <optional>
 
+#include <chrono>
+
 #include <memory>
 
 #include <ztd/ztd.hxx>
@@ -137,6 +139,9 @@ const std::shared_ptr<vfs::volume>
 volume_get_by_device(const std::string_view device_file) noexcept;
 
 bool volume_dir_avoid_changes(const std::filesystem::path& dir) noexcept;
+// how often a dir that avoids changes is checked for changes, from xset::name::dev_change_poll.
+// 0 if its filesystem is not polled.
+std::chrono::seconds volume_dir_poll_interval(const std::filesystem::path& dir) noexcept;
 
 bool is_path_mountpoint(const std::filesystem::path& path) noexcept;
 } // namespace vfs
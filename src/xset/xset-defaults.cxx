@@ -81,6 +81,7 @@ xset_defaults() noexcept
             xset::name::separator,
             xset::name::dev_menu_auto,
             xset::name::dev_change,
+            xset::name::dev_change_poll,
             xset::name::separator,
             xset::name::dev_single,
             xset::name::dev_newtab,
@@ -262,6 +263,22 @@ xset_defaults() noexcept
         set->z = set->s;
     }
 
+    {
+        const auto set = xset_get(xset::name::dev_change_poll);
+        set->menu.label = "Change _Polling";
+        set->desc =
+            "Enter your comma- or space-separated list of filesystem=seconds.  Directories on "
+            "filesystems in the Change Detection Blacklist are checked for added and removed files "
+            "this often instead of being monitored, less often while nothing changes.  Files "
+            "changed in place are not detected.  Filesystems not listed, or with 0 seconds, are "
+            "not checked.";
+        set->menu.type = xset::set::menu_type::string;
+        set->title = "Change Polling Intervals";
+        set->icon = "gtk-edit";
+        set->s = "cifs=30 curlftpfs=60 ftpfs=60 fuse.sshfs=15 nfs=10 smbfs=30";
+        set->z = set->s;
+    }
+
     // Bookmarks
     {
         const auto set = xset_get(xset::name::book_open);
@@ -65,6 +65,7 @@ enum class name
     dev_unmount_quit,
 
     dev_change,
+    dev_change_poll,
     dev_fs_cnf,
     dev_net_cnf,
 
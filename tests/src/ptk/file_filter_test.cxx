@@ -0,0 +1,106 @@
+/**
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "spacefm/ptk/ptk-file-filter.hxx"
+
+TEST(file_filter, empty)
+{
+    EXPECT_TRUE(ptk::file_filter("").match("file.txt"));
+    EXPECT_TRUE(ptk::file_filter(";;").match("file.txt"));
+    EXPECT_TRUE(ptk::file_filter("~").match("file.txt"));
+    EXPECT_TRUE(ptk::file_filter("re:").match("file.txt"));
+}
+
+TEST(file_filter, substring)
+{
+    const ptk::file_filter filter("photo");
+
+    EXPECT_TRUE(filter.match("photo.png"));
+    EXPECT_TRUE(filter.match("Holiday PHOTOS 2024"));
+    EXPECT_TRUE(filter.match("a long file name that has the word photo after sixteen bytes"));
+    EXPECT_FALSE(filter.match("phot.png"));
+    EXPECT_FALSE(filter.match(""));
+}
+
+TEST(file_filter, substring_utf8)
+{
+    EXPECT_TRUE(ptk::file_filter("ärger").match("Großer ÄRGER.txt"));
+    EXPECT_TRUE(ptk::file_filter("strasse").match("Hauptstraße 1"));
+    EXPECT_FALSE(ptk::file_filter("ärger").match("arger"));
+}
+
+TEST(file_filter, glob)
+{
+    EXPECT_TRUE(ptk::file_filter("*.jpg").match("image.jpg"));
+    EXPECT_FALSE(ptk::file_filter("*.jpg").match("image.JPG"));
+    EXPECT_FALSE(ptk::file_filter("*.jpg").match("image.jpg.txt"));
+
+    EXPECT_TRUE(ptk::file_filter("IMG_*").match("IMG_0001.jpg"));
+    EXPECT_FALSE(ptk::file_filter("IMG_*").match("xIMG_0001.jpg"));
+
+    EXPECT_TRUE(ptk::file_filter("*_00*").match("IMG_0001.jpg"));
+    EXPECT_FALSE(ptk::file_filter("*_00*").match("IMG_1001.jpg"));
+
+    EXPECT_TRUE(ptk::file_filter("IMG_????.jpg").match("IMG_0001.jpg"));
+    EXPECT_TRUE(ptk::file_filter("[a-c]*").match("beta"));
+    EXPECT_FALSE(ptk::file_filter("[a-c]*").match("delta"));
+}
+
+TEST(file_filter, multiple_terms)
+{
+    const ptk::file_filter filter("*.jpg;*.png;notes");
+
+    EXPECT_TRUE(filter.match("a.jpg"));
+    EXPECT_TRUE(filter.match("b.png"));
+    EXPECT_TRUE(filter.match("Meeting Notes.odt"));
+    EXPECT_FALSE(filter.match("c.gif"));
+}
+
+TEST(file_filter, fuzzy)
+{
+    const ptk::file_filter filter("~sfp");
+
+    EXPECT_TRUE(filter.match("Screenshot from photos.png"));
+    EXPECT_TRUE(filter.match("SFP"));
+    EXPECT_FALSE(filter.match("pfs"));
+}
+
+TEST(file_filter, regex)
+{
+    const ptk::file_filter filter("re:^img_[0-9]+\\.jpe?g$");
+
+    EXPECT_TRUE(filter.match("IMG_0001.jpeg"));
+    EXPECT_TRUE(filter.match("img_1.jpg"));
+    EXPECT_FALSE(filter.match("img_.jpg"));
+
+    // an invalid expression, still being typed, matches everything
+    EXPECT_TRUE(ptk::file_filter("re:img_(").match("file.txt"));
+}
+
+TEST(file_filter, narrows)
+{
+    EXPECT_TRUE(ptk::file_filter("photo").narrows(ptk::file_filter("pho")));
+    EXPECT_TRUE(ptk::file_filter("photo").narrows(ptk::file_filter("")));
+    EXPECT_TRUE(ptk::file_filter("~sfpn").narrows(ptk::file_filter("~sp")));
+    EXPECT_TRUE(ptk::file_filter("*.jpg").narrows(ptk::file_filter("*jpg")));
+    EXPECT_TRUE(ptk::file_filter("IMG_0*").narrows(ptk::file_filter("IMG_*")));
+
+    EXPECT_FALSE(ptk::file_filter("pho").narrows(ptk::file_filter("photo")));
+    EXPECT_FALSE(ptk::file_filter("a;b").narrows(ptk::file_filter("a")));
+    EXPECT_FALSE(ptk::file_filter("").narrows(ptk::file_filter("a")));
+    EXPECT_FALSE(ptk::file_filter("re:ab").narrows(ptk::file_filter("re:a")));
+}
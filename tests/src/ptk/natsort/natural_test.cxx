@@ -0,0 +1,206 @@
+/**
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <string_view>
+
+#include <vector>
+
+#include <algorithm>
+
+#include <random>
+
+#include "spacefm/ptk/natsort/natural.hxx"
+#include "spacefm/ptk/natsort/strnatcmp.hxx"
+
+#include "test_data.hxx"
+
+static i32
+sign(const i32 result)
+{
+    return result < 0 ? -1 : (result > 0 ? 1 : 0);
+}
+
+// ASCII names built to hit digit runs, leading zeros, whitespace and the
+// characters between 'Z' and 'a', long enough for the vectorized paths
+static std::vector<std::string>
+random_ascii_names()
+{
+    static constexpr std::string_view alphabet{"0000119aAzZ_[` \t.-bB"};
+
+    std::mt19937 rng(42);
+    const auto random_char = [&rng]() { return alphabet[rng() % alphabet.size()]; };
+
+    std::vector<std::string> names;
+    for (usize i = 0; i < 500; ++i)
+    {
+        std::string name;
+        const auto length = rng() % 40;
+        for (usize j = 0; j < length; ++j)
+        {
+            name.push_back(random_char());
+        }
+        names.push_back(name);
+
+        // names that share a long prefix with the previous one
+        auto changed = name;
+        if (!changed.empty())
+        {
+            changed[rng() % changed.size()] = random_char();
+        }
+        names.push_back(changed);
+        names.push_back(name + random_char());
+    }
+    return names;
+}
+
+static std::vector<std::string>
+test_data_names()
+{
+    std::vector<std::string> names;
+    for (const auto& data : {data::dates::unsorted,
+                             data::fractions::unsorted,
+                             data::words::unsorted,
+                             data::simple_names::unsorted})
+    {
+        names.insert(names.end(), data.cbegin(), data.cend());
+    }
+    return names;
+}
+
+TEST(natsort_natural, dates)
+{
+    auto unsorted = data::dates::unsorted;
+    auto sorted = data::dates::sorted;
+
+    std::ranges::sort(unsorted, [](auto a, auto b) { return ptk::natsort::compare(a, b) < 0; });
+
+    EXPECT_EQ(unsorted, sorted);
+}
+
+TEST(natsort_natural, fractions)
+{
+    auto unsorted = data::fractions::unsorted;
+    auto sorted = data::fractions::sorted;
+
+    std::ranges::sort(unsorted, [](auto a, auto b) { return ptk::natsort::compare(a, b) < 0; });
+
+    EXPECT_EQ(unsorted, sorted);
+}
+
+TEST(natsort_natural, words)
+{
+    auto unsorted = data::words::unsorted;
+    auto sorted = data::words::sorted;
+
+    std::ranges::sort(unsorted, [](auto a, auto b) { return ptk::natsort::compare(a, b) < 0; });
+
+    EXPECT_EQ(unsorted, sorted);
+}
+
+TEST(natsort_natural, simple_names)
+{
+    auto unsorted = data::simple_names::unsorted;
+    auto sorted = data::simple_names::sorted;
+
+    std::ranges::sort(unsorted, [](auto a, auto b) { return ptk::natsort::compare(a, b) < 0; });
+
+    EXPECT_EQ(unsorted, sorted);
+}
+
+TEST(natsort_natural, ascii_equivalence)
+{
+    for (const auto& names : {test_data_names(), random_ascii_names()})
+    {
+        for (const auto& a : names)
+        {
+            for (const auto& b : names)
+            {
+                ASSERT_EQ(sign(ptk::natsort::compare(a, b)), sign(strnatcmp(a, b)))
+                    << "'" << a << "' '" << b << "'";
+            }
+        }
+    }
+}
+
+TEST(natsort_natural, ascii_equivalence_icase)
+{
+    for (const auto& names : {test_data_names(), random_ascii_names()})
+    {
+        for (const auto& a : names)
+        {
+            for (const auto& b : names)
+            {
+                ASSERT_EQ(sign(ptk::natsort::compare_icase(a, b)), sign(strnatcasecmp(a, b)))
+                    << "'" << a << "' '" << b << "'";
+            }
+        }
+    }
+}
+
+TEST(natsort_natural, fold_keys)
+{
+    const auto names = random_ascii_names();
+
+    std::vector<std::string> keys;
+    for (const auto& name : names)
+    {
+        keys.push_back(ptk::natsort::fold(name));
+    }
+
+    for (usize i = 0; i < names.size(); ++i)
+    {
+        for (usize j = 0; j < names.size(); ++j)
+        {
+            ASSERT_EQ(sign(ptk::natsort::compare(keys[i], keys[j])),
+                      sign(ptk::natsort::compare_icase(names[i], names[j])))
+                << "'" << names[i] << "' '" << names[j] << "'";
+        }
+    }
+}
+
+TEST(natsort_natural, utf8_case_folding)
+{
+    EXPECT_EQ(ptk::natsort::compare_icase("Ärger", "ärger"), 0);
+    EXPECT_EQ(ptk::natsort::compare_icase("ÉCOLE 10", "école 10"), 0);
+    EXPECT_EQ(ptk::natsort::compare_icase("straße", "STRASSE"), 0);
+    EXPECT_EQ(ptk::natsort::compare_icase("Σίσυφος", "ΣΊΣΥΦΟΣ"), 0);
+
+    EXPECT_LT(ptk::natsort::compare_icase("Ärger 2", "ärger 10"), 0);
+    EXPECT_LT(ptk::natsort::compare_icase("файл 9", "ФАЙЛ 10"), 0);
+
+    EXPECT_EQ(ptk::natsort::fold("Ärger"), ptk::natsort::fold("äRGER"));
+    EXPECT_EQ(ptk::natsort::fold("abc"), "ABC");
+}
+
+TEST(natsort_natural, utf8_code_point_order)
+{
+    // case sensitive compares code points, not signed bytes
+    EXPECT_LT(ptk::natsort::compare("z", "ä"), 0);
+    EXPECT_LT(ptk::natsort::compare("ä", "€"), 0);
+    EXPECT_LT(ptk::natsort::compare("ä2", "ä10"), 0);
+}
+
+TEST(natsort_natural, invalid_utf8)
+{
+    const std::string invalid{"name \xff\xfe 2"};
+    const std::string invalid_upper{"NAME \xff\xfe 10"};
+
+    EXPECT_EQ(ptk::natsort::fold(invalid), "NAME \xff\xfe 2");
+    EXPECT_LT(ptk::natsort::compare_icase(invalid, invalid_upper), 0);
+    EXPECT_EQ(ptk::natsort::compare_icase(invalid, invalid), 0);
+}